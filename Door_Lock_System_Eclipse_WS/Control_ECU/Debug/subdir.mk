@@ -4,37 +4,61 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../adc.c \
 ../buzzer.c \
 ../dcmotor.c \
+../dcmotor_profile.c \
+../door_control.c \
+../door_guard.c \
+../door_position.c \
+../door_travel.c \
 ../external_eeprom.c \
 ../gpio.c \
+../link.c \
 ../main.c \
 ../pir.c \
 ../pwm.c \
+../tick.c \
 ../timer.c \
 ../twi.c \
 ../uart.c 
 
 OBJS += \
+./adc.o \
 ./buzzer.o \
 ./dcmotor.o \
+./dcmotor_profile.o \
+./door_control.o \
+./door_guard.o \
+./door_position.o \
+./door_travel.o \
 ./external_eeprom.o \
 ./gpio.o \
+./link.o \
 ./main.o \
 ./pir.o \
 ./pwm.o \
+./tick.o \
 ./timer.o \
 ./twi.o \
 ./uart.o 
 
 C_DEPS += \
+./adc.d \
 ./buzzer.d \
 ./dcmotor.d \
+./dcmotor_profile.d \
+./door_control.d \
+./door_guard.d \
+./door_position.d \
+./door_travel.d \
 ./external_eeprom.d \
 ./gpio.d \
+./link.d \
 ./main.d \
 ./pir.d \
 ./pwm.d \
+./tick.d \
 ./timer.d \
 ./twi.d \
 ./uart.d 
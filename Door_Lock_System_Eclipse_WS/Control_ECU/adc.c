@@ -0,0 +1,218 @@
+/*
+ *  File: Source file for ADC Driver
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "adc.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+typedef struct
+{
+	uint16 samples[ADC_RING_BUFFER_SIZE];
+	uint16 samples_sum;
+	uint16 ema_scaled;				/* running average multiplied by 2^ADC_EMA_SHIFT */
+	uint8 newest_index;
+	uint8 num_of_samples;
+}ADC_ChannelDataType;
+
+static ADC_ChannelDataType g_adc_channel_data[ADC_MAX_SEQUENCE_CHANNELS];
+/* slot of each ADC channel in g_adc_channel_data, ADC_INVALID_CHANNEL if not sampled */
+static uint8 g_adc_channel_slot[ADC_NUM_OF_CHANNELS];
+static uint8 g_adc_sequence[ADC_MAX_SEQUENCE_CHANNELS];
+static uint8 g_adc_sequence_length = 0;
+/*
+ * In free-running mode the next conversion starts as soon as one finishes,
+ * so a channel written to ADMUX in the ISR is converted one result later
+ */
+static volatile uint8 g_adc_converting_slot = 0;
+static volatile uint8 g_adc_queued_slot = 0;
+static void(*volatile g_adc_callBackPtr)(uint8 channel, uint16 sample) = NULL_PTR;
+static uint8 g_adc_admux_reference = 0;
+
+/******************************************************
+ * 						ISRs
+ ******************************************************/
+ISR(ADC_vect)
+{
+	uint16 sample = ADC;
+	uint8 slot = g_adc_converting_slot;
+	ADC_ChannelDataType* data_Ptr = &g_adc_channel_data[slot];
+
+	/* the queued conversion is already running, queue the one after it */
+	g_adc_converting_slot = g_adc_queued_slot;
+	g_adc_queued_slot++;
+	if(g_adc_queued_slot >= g_adc_sequence_length)
+	{
+		g_adc_queued_slot = 0;
+	}
+	ADMUX = g_adc_admux_reference | g_adc_sequence[g_adc_queued_slot];
+
+	/* ring buffer with a running sum so the mean costs no loop */
+	data_Ptr->newest_index = (data_Ptr->newest_index + 1) & (ADC_RING_BUFFER_SIZE - 1);
+	if(data_Ptr->num_of_samples < ADC_RING_BUFFER_SIZE)
+	{
+		data_Ptr->num_of_samples++;
+		data_Ptr->ema_scaled = (data_Ptr->num_of_samples == 1) ? (sample << ADC_EMA_SHIFT) : data_Ptr->ema_scaled;
+	}
+	else
+	{
+		data_Ptr->samples_sum -= data_Ptr->samples[data_Ptr->newest_index];
+	}
+	data_Ptr->samples[data_Ptr->newest_index] = sample;
+	data_Ptr->samples_sum += sample;
+	data_Ptr->ema_scaled = data_Ptr->ema_scaled - (data_Ptr->ema_scaled >> ADC_EMA_SHIFT) + sample;
+
+	if(g_adc_callBackPtr != NULL_PTR)
+	{
+		(*g_adc_callBackPtr)(g_adc_sequence[slot], sample);
+	}
+}
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Returns the data of a sampled channel or NULL_PTR
+ */
+static ADC_ChannelDataType* ADC_getChannelData(uint8 channel)
+{
+	if((channel >= ADC_NUM_OF_CHANNELS) || (g_adc_channel_slot[channel] == ADC_INVALID_CHANNEL))
+	{
+		return NULL_PTR;
+	}
+	return &g_adc_channel_data[g_adc_channel_slot[channel]];
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void ADC_init(const ADC_ConfigType* Config_Ptr)
+{
+	uint8 index;
+
+	ADC_deInit();
+	for(index = 0; index < ADC_NUM_OF_CHANNELS; index++)
+	{
+		g_adc_channel_slot[index] = ADC_INVALID_CHANNEL;
+	}
+	g_adc_sequence_length = 0;
+	for(index = 0; (index < Config_Ptr->num_of_channels) && (index < ADC_MAX_SEQUENCE_CHANNELS); index++)
+	{
+		g_adc_sequence[index] = Config_Ptr->channels[index] & (ADC_NUM_OF_CHANNELS - 1);
+		g_adc_channel_slot[g_adc_sequence[index]] = index;
+		g_adc_channel_data[index].num_of_samples = 0;
+		g_adc_channel_data[index].newest_index = 0;
+		g_adc_channel_data[index].samples_sum = 0;
+		g_adc_channel_data[index].ema_scaled = 0;
+	}
+	g_adc_sequence_length = index;
+	if(g_adc_sequence_length == 0)
+	{
+		return;
+	}
+
+	/*
+	 * Reference select and right adjusted result, the first channel is both
+	 * converting and queued because the second conversion starts before the ISR runs
+	 */
+	g_adc_admux_reference = (uint8)(Config_Ptr->reference << REFS0);
+	ADMUX = g_adc_admux_reference | g_adc_sequence[0];
+	g_adc_converting_slot = 0;
+	g_adc_queued_slot = 0;
+
+	/* free-running trigger source */
+	SFIOR &= ~((1<<ADTS2) | (1<<ADTS1) | (1<<ADTS0));
+	/* enable, auto trigger, interrupt, prescaler and start */
+	ADCSRA = (1<<ADEN) | (1<<ADATE) | (1<<ADIE) | (1<<ADIF) | (Config_Ptr->prescaler & 0x07);
+	SET_BIT(ADCSRA, ADSC);
+}
+
+void ADC_deInit(void)
+{
+	ADCSRA = (1<<ADIF);
+}
+
+void ADC_setCallBack(void(*a_ptr)(uint8 channel, uint16 sample))
+{
+	g_adc_callBackPtr = a_ptr;
+}
+
+uint16 ADC_getLastSample(uint8 channel)
+{
+	ADC_ChannelDataType* data_Ptr = ADC_getChannelData(channel);
+	uint16 sample;
+	uint8 sreg_value;
+	if(data_Ptr == NULL_PTR)
+	{
+		return 0;
+	}
+	sreg_value = SREG;
+	cli();
+	sample = data_Ptr->samples[data_Ptr->newest_index];
+	SREG = sreg_value;
+	return sample;
+}
+
+uint16 ADC_getAverage(uint8 channel)
+{
+	ADC_ChannelDataType* data_Ptr = ADC_getChannelData(channel);
+	uint16 samples_sum;
+	uint8 num_of_samples;
+	uint8 sreg_value;
+	if(data_Ptr == NULL_PTR)
+	{
+		return 0;
+	}
+	sreg_value = SREG;
+	cli();
+	samples_sum = data_Ptr->samples_sum;
+	num_of_samples = data_Ptr->num_of_samples;
+	SREG = sreg_value;
+	if(num_of_samples == 0)
+	{
+		return 0;
+	}
+	return (num_of_samples == ADC_RING_BUFFER_SIZE) ? (samples_sum / ADC_RING_BUFFER_SIZE) : (samples_sum / num_of_samples);
+}
+
+uint16 ADC_getFilteredValue(uint8 channel)
+{
+	ADC_ChannelDataType* data_Ptr = ADC_getChannelData(channel);
+	uint16 ema_scaled;
+	uint8 sreg_value;
+	if(data_Ptr == NULL_PTR)
+	{
+		return 0;
+	}
+	sreg_value = SREG;
+	cli();
+	ema_scaled = data_Ptr->ema_scaled;
+	SREG = sreg_value;
+	return (ema_scaled >> ADC_EMA_SHIFT);
+}
+
+uint8 ADC_readSamples(uint8 channel, uint16* samples_Ptr, uint8 max_samples)
+{
+	ADC_ChannelDataType* data_Ptr = ADC_getChannelData(channel);
+	uint8 num_of_samples, sample_index, copied;
+	uint8 sreg_value;
+	if(data_Ptr == NULL_PTR)
+	{
+		return 0;
+	}
+	sreg_value = SREG;
+	cli();
+	num_of_samples = (data_Ptr->num_of_samples < max_samples) ? data_Ptr->num_of_samples : max_samples;
+	sample_index = (data_Ptr->newest_index - num_of_samples + 1) & (ADC_RING_BUFFER_SIZE - 1);
+	for(copied = 0; copied < num_of_samples; copied++)
+	{
+		samples_Ptr[copied] = data_Ptr->samples[sample_index];
+		sample_index = (sample_index + 1) & (ADC_RING_BUFFER_SIZE - 1);
+	}
+	SREG = sreg_value;
+	return num_of_samples;
+}
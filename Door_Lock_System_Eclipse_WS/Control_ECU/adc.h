@@ -0,0 +1,105 @@
+/*
+ *  File: Header file for ADC Driver
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef ADC_H_
+#define ADC_H_
+
+#include "std_types.h"
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/* Channels converted in turn by the free-running sequence */
+#define ADC_MAX_SEQUENCE_CHANNELS		4u
+/* Samples kept per channel, must be a power of 2 */
+#define ADC_RING_BUFFER_SIZE			8u
+/* Running average weight is 1 / 2^ADC_EMA_SHIFT */
+#define ADC_EMA_SHIFT					3u
+
+#define ADC_MAX_VALUE					1023u
+#define ADC_NUM_OF_CHANNELS				8u
+#define ADC_INVALID_CHANNEL				0xFFu
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+typedef enum
+{
+	ADC_REF_AREF = 0,
+	ADC_REF_AVCC = 1,
+	ADC_REF_INTERNAL_2_56V = 3
+}ADC_ReferenceType;
+
+typedef enum
+{
+	ADC_F_CPU_2 = 1,
+	ADC_F_CPU_4,
+	ADC_F_CPU_8,
+	ADC_F_CPU_16,
+	ADC_F_CPU_32,
+	ADC_F_CPU_64,
+	ADC_F_CPU_128
+}ADC_PrescalerType;
+
+typedef struct
+{
+	ADC_ReferenceType reference;
+	ADC_PrescalerType prescaler;
+	uint8 num_of_channels;
+	uint8 channels[ADC_MAX_SEQUENCE_CHANNELS];
+}ADC_ConfigType;
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Starts free-running conversions cycling through the configured channels,
+ * each result is stored by the ADC interrupt
+ */
+void ADC_init(const ADC_ConfigType* Config_Ptr);
+
+/*
+ * Description:
+ * Stops the conversions and turns the ADC off
+ */
+void ADC_deInit(void);
+
+/*
+ * Description:
+ * Registers a function called from the ADC interrupt with every new sample,
+ * it must be short as it runs once per conversion
+ */
+void ADC_setCallBack(void(*a_ptr)(uint8 channel, uint16 sample));
+
+/*
+ * Description:
+ * Returns the newest sample of the channel
+ */
+uint16 ADC_getLastSample(uint8 channel);
+
+/*
+ * Description:
+ * Returns the mean of the samples held in the channel ring buffer
+ */
+uint16 ADC_getAverage(uint8 channel);
+
+/*
+ * Description:
+ * Returns the exponential running average of the channel
+ */
+uint16 ADC_getFilteredValue(uint8 channel);
+
+/*
+ * Description:
+ * Copies up to max_samples of the newest samples oldest first,
+ * returns the number of samples copied
+ */
+uint8 ADC_readSamples(uint8 channel, uint16* samples_Ptr, uint8 max_samples);
+
+#endif /* ADC_H_ */
@@ -7,22 +7,163 @@
  */
 #include "gpio.h"
 #include "buzzer.h"
+#include "timer.h"
+#include "tick.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define BUZZER_NO_PATTERN			BUZZER_NUM_OF_PATTERNS
+
+typedef struct
+{
+	const Buzzer_StepType* steps;
+	uint8 num_of_steps;
+	uint8 repeat_count;		/* BUZZER_REPEAT_FOREVER plays until Buzzer_off() */
+}Buzzer_PatternDescType;
+
+/*
+ * Pattern tables live in flash, only the playing position is kept in RAM
+ */
+static const Buzzer_StepType g_buzzer_alarm_steps[] PROGMEM =
+{
+	{BUZZER_TONE(1000UL), BUZZER_DURATION(300)},
+	{BUZZER_TONE(1600UL), BUZZER_DURATION(300)}
+};
+
+static const Buzzer_StepType g_buzzer_key_click_steps[] PROGMEM =
+{
+	{BUZZER_TONE(3000UL), BUZZER_DURATION(20)}
+};
+
+static const Buzzer_StepType g_buzzer_door_warning_steps[] PROGMEM =
+{
+	{BUZZER_TONE(2500UL), BUZZER_DURATION(60)},
+	{BUZZER_SILENCE, BUZZER_DURATION(60)},
+	{BUZZER_TONE(2500UL), BUZZER_DURATION(60)},
+	{BUZZER_SILENCE, BUZZER_DURATION(820)}
+};
+
+static const Buzzer_PatternDescType g_buzzer_patterns[BUZZER_NUM_OF_PATTERNS] PROGMEM =
+{
+	{g_buzzer_alarm_steps, 2, BUZZER_REPEAT_FOREVER},
+	{g_buzzer_key_click_steps, 1, 1},
+	{g_buzzer_door_warning_steps, 4, BUZZER_REPEAT_FOREVER}
+};
+
+static volatile Buzzer_PatternType g_buzzer_pattern = BUZZER_NO_PATTERN;
+static volatile boolean g_buzzer_is_tone_on = FALSE;
+static const Buzzer_StepType* g_buzzer_steps = NULL_PTR;
+static uint8 g_buzzer_num_of_steps = 0;
+static uint8 g_buzzer_step_index = 0;
+static uint8 g_buzzer_repeats_left = 0;
+static uint16 g_buzzer_step_time_left_ms = 0;
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Called by the timer driver on each Timer2 compare match
+ */
+static void Buzzer_toggleCallBack(void)
+{
+	TOGGLE_BIT(BUZZER_PORT_DATA_R, BUZZER_PIN_ID);
+}
+
+/*
+ * Description:
+ * Starts the given tone or silences the buzzer
+ */
+static void Buzzer_startTone(uint8 tone)
+{
+#if (BUZZER_TYPE_SELECT == BUZZER_PASSIVE)
+	Timer_ConfigType buzzer_timer_config = {0, 0, TIMER2, BUZZER_TIMER_CLOCK, TIMER_COMPARE_MODE};
+	Timer_deInit(TIMER2);
+	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	if(tone != BUZZER_SILENCE)
+	{
+		buzzer_timer_config.timer_compare_MatchValue = tone;
+		Timer_init(&buzzer_timer_config);
+	}
+#else
+	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, (tone != BUZZER_SILENCE) ? LOGIC_HIGH : LOGIC_LOW);
+#endif
+	g_buzzer_is_tone_on = (tone != BUZZER_SILENCE);
+}
+
 /*
  * Description:
- * intializes buzzer direction to output
+ * Plays the step at the current index of the playing pattern
+ */
+static void Buzzer_loadStep(void)
+{
+	const Buzzer_StepType* step_ptr = &g_buzzer_steps[g_buzzer_step_index];
+	g_buzzer_step_time_left_ms = (uint16)pgm_read_byte(&step_ptr->duration) * BUZZER_DURATION_UNIT_MS;
+	Buzzer_startTone(pgm_read_byte(&step_ptr->tone));
+}
+
+/*
+ * Description:
+ * Advances the playing pattern, runs every tick
+ */
+static void Buzzer_tickHook(void)
+{
+	if(g_buzzer_pattern == BUZZER_NO_PATTERN)
+	{
+		return;
+	}
+	if(g_buzzer_step_time_left_ms > TICK_PERIOD_MS)
+	{
+		g_buzzer_step_time_left_ms -= TICK_PERIOD_MS;
+		return;
+	}
+
+	g_buzzer_step_index++;
+	if(g_buzzer_step_index >= g_buzzer_num_of_steps)
+	{
+		g_buzzer_step_index = 0;
+		if(g_buzzer_repeats_left != BUZZER_REPEAT_FOREVER)
+		{
+			g_buzzer_repeats_left--;
+			if(g_buzzer_repeats_left == 0)
+			{
+				g_buzzer_pattern = BUZZER_NO_PATTERN;
+				Buzzer_startTone(BUZZER_SILENCE);
+				return;
+			}
+		}
+	}
+	Buzzer_loadStep();
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+/*
+ * Description:
+ * intializes buzzer direction to output and attaches the pattern
+ * sequencer to the system tick
  */
 void Buzzer_init(void)
 {
 	GPIO_setupPinDirection(BUZZER_PORT_ID, BUZZER_PIN_ID, PIN_OUTPUT);
+	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	Timer_setCallBack(Buzzer_toggleCallBack, TIMER2);
+	Tick_addHook(Buzzer_tickHook);
 }
 
 /*
  * Description:
- * turns on the buzzer
+ * turns on the buzzer with a continuous tone
  */
 void Buzzer_on(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_HIGH);
+	uint8 sreg_value = SREG;
+	cli();
+	g_buzzer_pattern = BUZZER_NO_PATTERN;
+	Buzzer_startTone(BUZZER_TONE(BUZZER_DEFAULT_FREQUENCY_HZ));
+	SREG = sreg_value;
 }
 
 /*
@@ -31,5 +172,40 @@ void Buzzer_on(void)
  */
 void Buzzer_off(void)
 {
-	GPIO_writePin(BUZZER_PORT_ID, BUZZER_PIN_ID, LOGIC_LOW);
+	uint8 sreg_value = SREG;
+	cli();
+	g_buzzer_pattern = BUZZER_NO_PATTERN;
+	Buzzer_startTone(BUZZER_SILENCE);
+	SREG = sreg_value;
+}
+
+/*
+ * Description:
+ * starts playing a pattern in the background
+ */
+void Buzzer_playPattern(Buzzer_PatternType pattern)
+{
+	uint8 sreg_value;
+	if(pattern >= BUZZER_NUM_OF_PATTERNS)
+	{
+		return;
+	}
+	sreg_value = SREG;
+	cli();
+	g_buzzer_steps = (const Buzzer_StepType*)pgm_read_ptr(&g_buzzer_patterns[pattern].steps);
+	g_buzzer_num_of_steps = pgm_read_byte(&g_buzzer_patterns[pattern].num_of_steps);
+	g_buzzer_repeats_left = pgm_read_byte(&g_buzzer_patterns[pattern].repeat_count);
+	g_buzzer_step_index = 0;
+	g_buzzer_pattern = pattern;
+	Buzzer_loadStep();
+	SREG = sreg_value;
+}
+
+/*
+ * Description:
+ * returns TRUE while a pattern or a continuous tone is playing
+ */
+boolean Buzzer_isPlaying(void)
+{
+	return ((g_buzzer_pattern != BUZZER_NO_PATTERN) || (g_buzzer_is_tone_on == TRUE));
 }
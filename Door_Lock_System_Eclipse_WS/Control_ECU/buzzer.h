@@ -8,34 +8,94 @@
 #ifndef BUZZER_H_
 #define BUZZER_H_
 #include "std_types.h"
+#include "gpio.h"
+
+/****************************************************************
+ * 						Types
+ ****************************************************************/
+typedef enum
+{
+	BUZZER_PATTERN_ALARM,			/* two tone siren, repeats until stopped */
+	BUZZER_PATTERN_KEY_CLICK,		/* one short click */
+	BUZZER_PATTERN_DOOR_WARNING,	/* double chirp every second, repeats until stopped */
+	BUZZER_NUM_OF_PATTERNS
+}Buzzer_PatternType;
+
+/*
+ * One step of a pattern, kept at two bytes so the pattern tables stay small
+ * tone: BUZZER_TONE(frequency) or BUZZER_SILENCE
+ * duration: BUZZER_DURATION(milliseconds)
+ */
+typedef struct
+{
+	uint8 tone;
+	uint8 duration;
+}Buzzer_StepType;
 
 /****************************************************************
  * 						Definitions
  ****************************************************************/
 #define BUZZER_PORT_ID								PORTC_ID
 #define BUZZER_PIN_ID								PIN7_ID
+/* written directly by the tone interrupt */
+#define BUZZER_PORT_DATA_R							GPIO_PORTC_DATA_R
+
+/*
+ * A passive buzzer is driven with a square wave at the tone frequency,
+ * an active buzzer has its own oscillator so it is only switched on and off
+ */
+#define BUZZER_PASSIVE								0u
+#define BUZZER_ACTIVE								1u
+#define BUZZER_TYPE_SELECT							BUZZER_PASSIVE
+
+/*
+ * Timer2 in compare mode toggles the pin from its interrupt, the OC2 pin
+ * (PD7) drives the motor bridge so the hardware toggle can't be used.
+ * With prescaler 32 tones from 489 Hz up to a few kHz are accurate
+ */
+#define BUZZER_TIMER_CLOCK							F_CLK_PRESCALE_32
+#define BUZZER_TIMER_PRESCALE						32UL
+#define BUZZER_TONE(FREQUENCY_HZ)					((uint8)((F_CPU / (2UL * BUZZER_TIMER_PRESCALE * (FREQUENCY_HZ))) - 1UL))
+#define BUZZER_SILENCE								0u
+#define BUZZER_DEFAULT_FREQUENCY_HZ					2000UL
+
+/* pattern steps advance from the system tick in 10 ms units */
+#define BUZZER_DURATION_UNIT_MS						10u
+#define BUZZER_DURATION(MS)							((uint8)((MS) / BUZZER_DURATION_UNIT_MS))
+#define BUZZER_REPEAT_FOREVER						0u
 
 /****************************************************************
  * 					Function Prototypes
  ****************************************************************/
 /*
  * Description:
- * intializes buzzer direction to output
+ * intializes buzzer direction to output and attaches the pattern
+ * sequencer to the system tick, Tick_init() must be called first
  */
 void Buzzer_init(void);
 
 /*
  * Description:
- * turns on the buzzer
+ * turns on the buzzer with a continuous tone
  */
 void Buzzer_on(void);
 
 /*
  * Description:
- * turns off the buzzer
+ * turns off the buzzer, also stops a playing pattern
  */
 void Buzzer_off(void);
 
+/*
+ * Description:
+ * starts playing a pattern in the background, replacing the one playing
+ */
+void Buzzer_playPattern(Buzzer_PatternType pattern);
 
+/*
+ * Description:
+ * returns TRUE while a pattern or a continuous tone is playing
+ */
+boolean Buzzer_isPlaying(void);
 
 #endif /* BUZZER_H_ */
@@ -9,6 +9,149 @@
 #include "pwm.h"
 #include "gpio.h"
 #include "common_macros.h"
+#include "adc.h"
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile DcMotor_State g_dcmotor_state = STOP;
+static volatile DcMotor_FaultType g_dcmotor_fault = DC_MOTOR_NO_FAULT;
+static volatile Tick_Type g_dcmotor_start_tick = 0;
+static volatile Tick_Type g_dcmotor_stall_start_tick = 0;
+static volatile boolean g_dcmotor_is_stall_timing = FALSE;
+static volatile uint8 g_dcmotor_overcurrent_samples = 0;
+/* direction driven last and when it stopped, used to enforce the dead time */
+static volatile DcMotor_State g_dcmotor_last_direction = STOP;
+static volatile Tick_Type g_dcmotor_drive_end_tick = 0;
+/* state applied once the dead time of a reversal has passed */
+static volatile uint8 g_dcmotor_dead_time_timer = TICK_INVALID_TIMER;
+static volatile DcMotor_State g_dcmotor_pending_state = STOP;
+static volatile uint8 g_dcmotor_pending_speed = 0;
+
+/*
+ * Description:
+ * Drives the bridge inputs and the PWM for the given state
+ */
+static void DcMotor_applyState(DcMotor_State dcMotor_state, uint8 dcMotor_speed)
+{
+	boolean is_driving = ((g_dcmotor_state == CW) || (g_dcmotor_state == ACW));
+	if(is_driving && (dcMotor_state != g_dcmotor_state))
+	{
+		g_dcmotor_last_direction = g_dcmotor_state;
+		g_dcmotor_drive_end_tick = Tick_getTicks();
+	}
+	if(((dcMotor_state == CW) || (dcMotor_state == ACW)) && (dcMotor_state != g_dcmotor_state))
+	{
+		g_dcmotor_start_tick = Tick_getTicks();
+		g_dcmotor_is_stall_timing = FALSE;
+		g_dcmotor_overcurrent_samples = 0;
+	}
+	g_dcmotor_state = dcMotor_state;
+	switch(dcMotor_state)
+	{
+	case STOP:
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_LOW);
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_LOW);
+		dcMotor_speed = 0;
+		break;
+	case ACW:
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_HIGH);
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_LOW);
+		break;
+	case CW:
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_LOW);
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_HIGH);
+		break;
+	case BRAKE:
+		/* both inputs change together with the enable low so no leg conducts alone */
+		PWM_setDuty(0);
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, DC_MOTOR_BRAKE_LEVEL);
+		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, DC_MOTOR_BRAKE_LEVEL);
+		break;
+	}
+	PWM_setDuty(dcMotor_speed);
+}
+
+/*
+ * Description:
+ * Called by the tick once the reversal dead time has passed
+ */
+static void DcMotor_deadTimeCallBack(void)
+{
+	g_dcmotor_dead_time_timer = TICK_INVALID_TIMER;
+	if(g_dcmotor_fault == DC_MOTOR_NO_FAULT)
+	{
+		DcMotor_applyState(g_dcmotor_pending_state, g_dcmotor_pending_speed);
+	}
+}
+
+/*
+ * Description:
+ * Cuts the bridge and the PWM at once and latches the fault
+ */
+static void DcMotor_trip(DcMotor_FaultType fault)
+{
+	Tick_stopTimer(g_dcmotor_dead_time_timer);
+	g_dcmotor_dead_time_timer = TICK_INVALID_TIMER;
+	if((g_dcmotor_state == CW) || (g_dcmotor_state == ACW))
+	{
+		g_dcmotor_last_direction = g_dcmotor_state;
+		g_dcmotor_drive_end_tick = Tick_getTicks();
+	}
+	GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_LOW);
+	GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_LOW);
+	PWM_setDuty(0);
+	g_dcmotor_state = STOP;
+	g_dcmotor_fault = fault;
+}
+
+/*
+ * Description:
+ * Called by the ADC interrupt with every current sample
+ */
+static void DcMotor_currentCallBack(uint8 channel, uint16 sample)
+{
+	/* braking current is expected, only a driven motor is checked */
+	if((channel != DC_MOTOR_CURRENT_ADC_CHANNEL) || ((g_dcmotor_state != CW) && (g_dcmotor_state != ACW)))
+	{
+		return;
+	}
+
+	if(sample >= DC_MOTOR_OVERCURRENT_LEVEL)
+	{
+		g_dcmotor_overcurrent_samples++;
+		if(g_dcmotor_overcurrent_samples >= DC_MOTOR_OVERCURRENT_SAMPLES)
+		{
+			DcMotor_trip(DC_MOTOR_OVERCURRENT);
+			return;
+		}
+	}
+	else
+	{
+		g_dcmotor_overcurrent_samples = 0;
+	}
+
+	if(Tick_elapsedSince(g_dcmotor_start_tick) < DC_MOTOR_INRUSH_BLANKING_MS)
+	{
+		return;
+	}
+	if(ADC_getFilteredValue(DC_MOTOR_CURRENT_ADC_CHANNEL) >= DC_MOTOR_STALL_LEVEL)
+	{
+		if(g_dcmotor_is_stall_timing == FALSE)
+		{
+			g_dcmotor_is_stall_timing = TRUE;
+			g_dcmotor_stall_start_tick = Tick_getTicks();
+		}
+		else if(Tick_elapsedSince(g_dcmotor_stall_start_tick) >= DC_MOTOR_STALL_TIME_MS)
+		{
+			DcMotor_trip(DC_MOTOR_STALL);
+		}
+	}
+	else
+	{
+		g_dcmotor_is_stall_timing = FALSE;
+	}
+}
 
 /*
  * Description:
@@ -26,28 +169,106 @@ void DcMotor_Init(void)
 	 */
 	GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_LOW);
 	GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_LOW);
+	PWM_init();
+	/*
+	 * Current monitoring, the ADC must sample DC_MOTOR_CURRENT_ADC_CHANNEL
+	 */
+	ADC_setCallBack(DcMotor_currentCallBack);
 }
 
 /*
  * Description:
- * Control motor speed and adjust motor state
+ * Control motor speed and adjust motor state, the speed of the BRAKE state is
+ * the braking strength. A reversal is delayed by the dead time and returns at once
  */
 void DcMotor_Rotate(DcMotor_State dcMotor_state, uint8 dcMotor_speed)
 {
-	switch(dcMotor_state)
+	DcMotor_State opposite_direction;
+	Tick_Type dead_time_left = 0;
+	uint8 sreg_value = SREG;
+	cli();
+	/* a latched fault keeps the motor stopped */
+	if(g_dcmotor_fault != DC_MOTOR_NO_FAULT)
 	{
-	case STOP:
-		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_LOW);
-		break;
-	case ACW:
-		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_HIGH);
-		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_LOW);
-		break;
-	case CW:
-		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT1_PIN_ID, LOGIC_LOW);
-		GPIO_writePin(DC_MOTOR_PORT_ID, DC_MOTOR_INT2_PIN_ID, LOGIC_HIGH);
-		break;
+		dcMotor_state = STOP;
+		dcMotor_speed = 0;
+	}
+	/* a new request replaces a reversal still waiting for its dead time */
+	Tick_stopTimer(g_dcmotor_dead_time_timer);
+	g_dcmotor_dead_time_timer = TICK_INVALID_TIMER;
+
+	if((dcMotor_state == CW) || (dcMotor_state == ACW))
+	{
+		opposite_direction = (dcMotor_state == CW) ? ACW : CW;
+		if(g_dcmotor_state == opposite_direction)
+		{
+			dead_time_left = DC_MOTOR_DEAD_TIME_MS;
+			DcMotor_applyState(DC_MOTOR_REVERSAL_STATE, DC_MOTOR_BRAKE_STRENGTH);
+		}
+		else if((g_dcmotor_state != dcMotor_state) && (g_dcmotor_last_direction == opposite_direction)
+				&& (Tick_elapsedSince(g_dcmotor_drive_end_tick) < DC_MOTOR_DEAD_TIME_MS))
+		{
+			dead_time_left = DC_MOTOR_DEAD_TIME_MS - Tick_elapsedSince(g_dcmotor_drive_end_tick);
+		}
+	}
+
+	if(dead_time_left != 0)
+	{
+		g_dcmotor_pending_state = dcMotor_state;
+		g_dcmotor_pending_speed = dcMotor_speed;
+		/* if no timer is free the motor is left stopped, which is the safe side */
+		g_dcmotor_dead_time_timer = Tick_startTimer((uint16)dead_time_left, DcMotor_deadTimeCallBack);
+	}
+	else
+	{
+		DcMotor_applyState(dcMotor_state, dcMotor_speed);
 	}
-	PWM_Timer0_Start(dcMotor_speed);
+	SREG = sreg_value;
+}
+
+/*
+ * Description:
+ * Changes the motor speed keeping its current state, used by speed ramps
+ */
+void DcMotor_setSpeed(uint8 dcMotor_speed)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	if(g_dcmotor_dead_time_timer != TICK_INVALID_TIMER)
+	{
+		g_dcmotor_pending_speed = dcMotor_speed;
+	}
+	else if((g_dcmotor_fault == DC_MOTOR_NO_FAULT) && (g_dcmotor_state != STOP))
+	{
+		PWM_setDuty(dcMotor_speed);
+	}
+	SREG = sreg_value;
+}
+
+/*
+ * Description:
+ * Returns the state the bridge is driven in now
+ */
+DcMotor_State DcMotor_getState(void)
+{
+	return g_dcmotor_state;
+}
+
+/*
+ * Description:
+ * Returns the detected motor fault, the motor stays stopped
+ * until the fault is cleared
+ */
+DcMotor_FaultType DcMotor_getFault(void)
+{
+	return g_dcmotor_fault;
+}
+
+/*
+ * Description:
+ * Clears a latched motor fault so the motor can be driven again
+ */
+void DcMotor_clearFault(void)
+{
+	g_dcmotor_fault = DC_MOTOR_NO_FAULT;
 }
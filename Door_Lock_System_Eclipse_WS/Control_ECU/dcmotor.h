@@ -16,9 +16,16 @@
 typedef enum{
 	STOP,
 	ACW,
-	CW
+	CW,
+	BRAKE
 }DcMotor_State;
 
+typedef enum{
+	DC_MOTOR_NO_FAULT,
+	DC_MOTOR_OVERCURRENT,
+	DC_MOTOR_STALL
+}DcMotor_FaultType;
+
 /*************************************************************
  * 					Definitions
  *************************************************************/
@@ -28,6 +35,19 @@ typedef enum{
 #define DC_MOTOR_PORT_ID									PORTD_ID
 #define DC_MOTOR_INT1_PIN_ID								PIN6_ID
 #define DC_MOTOR_INT2_PIN_ID								PIN7_ID
+/*
+ * Bridge inputs level that brakes the motor (both inputs equal with the
+ * enable on shorts the windings), both inputs low with the enable off coasts
+ */
+#define DC_MOTOR_BRAKE_LEVEL								LOGIC_HIGH
+/* braking strength (duty) used at the end of a door move */
+#define DC_MOTOR_BRAKE_STRENGTH								100u
+/*
+ * A reversal first brakes (or coasts) the motor for the dead time so the
+ * bridge never switches directly between CW and ACW
+ */
+#define DC_MOTOR_REVERSAL_STATE								BRAKE
+#define DC_MOTOR_DEAD_TIME_MS								20u
 /*
  * MOTOR_SPEEDs
  */
@@ -36,6 +56,20 @@ typedef enum{
 #define DC_MOTOR_SPEED_50									50u
 #define DC_MOTOR_SPEED_75									75u
 
+/*
+ * Motor current is sampled by the ADC over a shunt resistor,
+ * levels are raw 10-bit ADC readings
+ */
+#define DC_MOTOR_CURRENT_ADC_CHANNEL						0u
+/* a short circuit trips after this many consecutive samples above the level */
+#define DC_MOTOR_OVERCURRENT_LEVEL							900u
+#define DC_MOTOR_OVERCURRENT_SAMPLES						3u
+/* a stalled motor draws this filtered current for longer than the stall time */
+#define DC_MOTOR_STALL_LEVEL								600u
+#define DC_MOTOR_STALL_TIME_MS								50u
+/* stall detection is ignored while the motor starts and draws inrush current */
+#define DC_MOTOR_INRUSH_BLANKING_MS							200u
+
 /*************************************************************
  * 					Function Prototypes
  *************************************************************/
@@ -46,9 +80,31 @@ typedef enum{
 void DcMotor_Init(void);
 /*
  * Description:
- * Control motor speed and adjust motor state
+ * Control motor speed and adjust motor state, the speed of the BRAKE state is
+ * the braking strength. A reversal is delayed by the dead time and returns at once
  */
 void DcMotor_Rotate(DcMotor_State dcMotor_state, uint8 dcMotor_speed);
+/*
+ * Description:
+ * Changes the motor speed keeping its current state, used by speed ramps
+ */
+void DcMotor_setSpeed(uint8 dcMotor_speed);
+/*
+ * Description:
+ * Returns the state the bridge is driven in now
+ */
+DcMotor_State DcMotor_getState(void);
+/*
+ * Description:
+ * Returns the detected motor fault, the motor stays stopped
+ * until the fault is cleared
+ */
+DcMotor_FaultType DcMotor_getFault(void);
+/*
+ * Description:
+ * Clears a latched motor fault so the motor can be driven again
+ */
+void DcMotor_clearFault(void);
 
 #endif /* DCMOTOR_H_ */
 
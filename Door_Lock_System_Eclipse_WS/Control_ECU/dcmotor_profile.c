@@ -0,0 +1,212 @@
+/*
+ *  File: Source file for DC Motor motion profiles
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "dcmotor_profile.h"
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static DcMotor_ProfileType g_profile;
+static volatile DcMotor_State g_profile_direction = STOP;
+static volatile DcMotor_PhaseType g_profile_phase = DC_MOTOR_PHASE_IDLE;
+static volatile uint16 g_profile_phase_elapsed_ms = 0;
+static volatile uint8 g_profile_update_ticks = 0;
+/* duty reached when the move was cut short, the deceleration starts from it */
+static volatile uint8 g_profile_decel_start_duty = 0;
+static volatile uint8 g_profile_duty = 0;
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Scales max_duty by the ramp fraction elapsed_ms / ramp_time_ms
+ */
+static uint8 DcMotor_rampDuty(uint8 max_duty, uint16 elapsed_ms, uint16 ramp_time_ms, DcMotor_RampShapeType shape)
+{
+	uint32 fraction;
+	if(elapsed_ms >= ramp_time_ms)
+	{
+		return max_duty;
+	}
+	fraction = ((uint32)elapsed_ms * DC_MOTOR_PROFILE_RAMP_RESOLUTION) / ramp_time_ms;
+	if(shape == DC_MOTOR_RAMP_S_CURVE)
+	{
+		/* smoothstep 3x^2 - 2x^3 in 1/256 fixed point */
+		fraction = (fraction * fraction * ((3UL * DC_MOTOR_PROFILE_RAMP_RESOLUTION) - (2UL * fraction)))
+				/ (DC_MOTOR_PROFILE_RAMP_RESOLUTION * DC_MOTOR_PROFILE_RAMP_RESOLUTION);
+	}
+	return (uint8)(((uint16)max_duty * fraction) / DC_MOTOR_PROFILE_RAMP_RESOLUTION);
+}
+
+/*
+ * Moves to the next phase, zero length phases are skipped
+ */
+static void DcMotor_nextPhase(void)
+{
+	g_profile_phase_elapsed_ms = 0;
+	switch(g_profile_phase)
+	{
+	case DC_MOTOR_PHASE_ACCELERATE:
+		g_profile_phase = DC_MOTOR_PHASE_CRUISE;
+		if(g_profile.cruise_time_ms != 0)
+		{
+			break;
+		}
+		/* no break */
+	case DC_MOTOR_PHASE_CRUISE:
+		g_profile_phase = DC_MOTOR_PHASE_DECELERATE;
+		g_profile_decel_start_duty = g_profile_duty;
+		if(g_profile.decel_time_ms != 0)
+		{
+			break;
+		}
+		/* no break */
+	default:
+		g_profile_phase = DC_MOTOR_PHASE_IDLE;
+		break;
+	}
+}
+
+/*
+ * Runs every tick, the duty is updated once per update period
+ */
+static void DcMotor_profileTickHook(void)
+{
+	uint8 duty = 0;
+	if(g_profile_phase == DC_MOTOR_PHASE_IDLE)
+	{
+		return;
+	}
+	/* the motor driver tripped on over-current or stall, abandon the move */
+	if(DcMotor_getFault() != DC_MOTOR_NO_FAULT)
+	{
+		g_profile_phase = DC_MOTOR_PHASE_IDLE;
+		g_profile_duty = 0;
+		return;
+	}
+	g_profile_update_ticks++;
+	if(g_profile_update_ticks < (DC_MOTOR_PROFILE_UPDATE_PERIOD_MS / TICK_PERIOD_MS))
+	{
+		return;
+	}
+	g_profile_update_ticks = 0;
+	g_profile_phase_elapsed_ms += DC_MOTOR_PROFILE_UPDATE_PERIOD_MS;
+
+	switch(g_profile_phase)
+	{
+	case DC_MOTOR_PHASE_ACCELERATE:
+		duty = DcMotor_rampDuty(g_profile.cruise_duty, g_profile_phase_elapsed_ms, g_profile.accel_time_ms, g_profile.ramp_shape);
+		g_profile_duty = duty;
+		if(g_profile_phase_elapsed_ms >= g_profile.accel_time_ms)
+		{
+			DcMotor_nextPhase();
+		}
+		break;
+	case DC_MOTOR_PHASE_CRUISE:
+		duty = g_profile.cruise_duty;
+		g_profile_duty = duty;
+		if(g_profile_phase_elapsed_ms >= g_profile.cruise_time_ms)
+		{
+			DcMotor_nextPhase();
+		}
+		break;
+	case DC_MOTOR_PHASE_DECELERATE:
+		duty = g_profile_decel_start_duty - DcMotor_rampDuty(g_profile_decel_start_duty, g_profile_phase_elapsed_ms, g_profile.decel_time_ms, g_profile.ramp_shape);
+		g_profile_duty = duty;
+		if(g_profile_phase_elapsed_ms >= g_profile.decel_time_ms)
+		{
+			DcMotor_nextPhase();
+		}
+		break;
+	default:
+		break;
+	}
+
+	if(g_profile_phase == DC_MOTOR_PHASE_IDLE)
+	{
+		g_profile_duty = 0;
+		DcMotor_Rotate(BRAKE, DC_MOTOR_BRAKE_STRENGTH);
+	}
+	else
+	{
+		DcMotor_setSpeed(duty);
+	}
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void DcMotor_profileInit(void)
+{
+	Tick_addHook(DcMotor_profileTickHook);
+}
+
+void DcMotor_moveProfile(DcMotor_State direction, const DcMotor_ProfileType* profile_Ptr)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	g_profile = *profile_Ptr;
+	g_profile_direction = direction;
+	g_profile_update_ticks = 0;
+	g_profile_phase_elapsed_ms = 0;
+	g_profile_duty = 0;
+	if(direction == STOP)
+	{
+		g_profile_phase = DC_MOTOR_PHASE_IDLE;
+		DcMotor_Rotate(STOP, 0);
+	}
+	else if(g_profile.accel_time_ms != 0)
+	{
+		g_profile_phase = DC_MOTOR_PHASE_ACCELERATE;
+		DcMotor_Rotate(direction, 0);
+	}
+	else
+	{
+		/* no acceleration ramp, start straight at the cruise duty */
+		g_profile_phase = DC_MOTOR_PHASE_ACCELERATE;
+		g_profile_duty = g_profile.cruise_duty;
+		DcMotor_nextPhase();
+		DcMotor_Rotate((g_profile_phase == DC_MOTOR_PHASE_IDLE) ? STOP : direction, g_profile_duty);
+	}
+	SREG = sreg_value;
+}
+
+void DcMotor_stopProfile(void)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	if((g_profile_phase == DC_MOTOR_PHASE_ACCELERATE) || (g_profile_phase == DC_MOTOR_PHASE_CRUISE))
+	{
+		g_profile_phase = DC_MOTOR_PHASE_CRUISE;
+		DcMotor_nextPhase();
+		if(g_profile_phase == DC_MOTOR_PHASE_IDLE)
+		{
+			DcMotor_Rotate(BRAKE, DC_MOTOR_BRAKE_STRENGTH);
+		}
+	}
+	SREG = sreg_value;
+}
+
+void DcMotor_haltProfile(void)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	g_profile_phase = DC_MOTOR_PHASE_IDLE;
+	g_profile_duty = 0;
+	DcMotor_Rotate(BRAKE, DC_MOTOR_BRAKE_STRENGTH);
+	SREG = sreg_value;
+}
+
+boolean DcMotor_isMoving(void)
+{
+	return (g_profile_phase != DC_MOTOR_PHASE_IDLE);
+}
+
+DcMotor_PhaseType DcMotor_getPhase(void)
+{
+	return g_profile_phase;
+}
@@ -0,0 +1,102 @@
+/*
+ *  File: Header file for DC Motor motion profiles
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef DCMOTOR_PROFILE_H_
+#define DCMOTOR_PROFILE_H_
+
+#include "std_types.h"
+#include "dcmotor.h"
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+typedef enum{
+	DC_MOTOR_RAMP_TRAPEZOIDAL,
+	DC_MOTOR_RAMP_S_CURVE
+}DcMotor_RampShapeType;
+
+typedef enum{
+	DC_MOTOR_PHASE_IDLE,
+	DC_MOTOR_PHASE_ACCELERATE,
+	DC_MOTOR_PHASE_CRUISE,
+	DC_MOTOR_PHASE_DECELERATE
+}DcMotor_PhaseType;
+
+/*
+ * A move ramps up from zero to cruise_duty during accel_time_ms, holds it
+ * for cruise_time_ms then ramps back to zero during decel_time_ms
+ */
+typedef struct{
+	uint16 accel_time_ms;
+	uint16 cruise_time_ms;
+	uint16 decel_time_ms;
+	uint8 cruise_duty;					/* percent 0 - 100 */
+	DcMotor_RampShapeType ramp_shape;
+}DcMotor_ProfileType;
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/* The duty is recalculated every update period instead of every tick */
+#define DC_MOTOR_PROFILE_UPDATE_PERIOD_MS		10u
+
+/* S-curve lookup is done in 1/256 steps of the ramp time */
+#define DC_MOTOR_PROFILE_RAMP_RESOLUTION		256UL
+
+/*
+ * Default door move, the phases add up to the 15 s door travel time
+ * the HMI ECU waits for
+ */
+#define DC_MOTOR_DEFAULT_ACCEL_TIME_MS			1000u
+#define DC_MOTOR_DEFAULT_CRUISE_TIME_MS			13000u
+#define DC_MOTOR_DEFAULT_DECEL_TIME_MS			1000u
+#define DC_MOTOR_DEFAULT_CRUISE_DUTY			100u
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Attaches the profile engine to the system tick, Tick_init() must be called first
+ */
+void DcMotor_profileInit(void);
+
+/*
+ * Description:
+ * Starts a move in the given direction and returns immediately,
+ * the ramps are run from the tick until DcMotor_isMoving() returns FALSE.
+ * A move already running is replaced by the new one
+ */
+void DcMotor_moveProfile(DcMotor_State direction, const DcMotor_ProfileType* profile_Ptr);
+
+/*
+ * Description:
+ * Skips to the deceleration ramp of the running move
+ */
+void DcMotor_stopProfile(void);
+
+/*
+ * Description:
+ * Stops the motor at once without a deceleration ramp, used when the
+ * door reaches its end position
+ */
+void DcMotor_haltProfile(void);
+
+/*
+ * Description:
+ * Returns TRUE while a move started by DcMotor_moveProfile() is running
+ */
+boolean DcMotor_isMoving(void);
+
+/*
+ * Description:
+ * Returns the phase of the running move
+ */
+DcMotor_PhaseType DcMotor_getPhase(void);
+
+#endif /* DCMOTOR_PROFILE_H_ */
@@ -0,0 +1,759 @@
+/*
+ *  File: Source file for Door control state machine
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include <string.h>
+#include "door_control.h"
+#include "door_travel.h"
+#include "door_guard.h"
+#include "dcmotor.h"
+#include "dcmotor_profile.h"
+#include "external_eeprom.h"
+#include "pir.h"
+#include "buzzer.h"
+#include "link.h"
+#include "uart.h"
+#include "tick.h"
+#include <avr/pgmspace.h>
+
+/*
+ * A transition runs its action (if any) which may redirect the transition,
+ * e.g. a failed move goes back to idle instead of the table's next state
+ */
+typedef struct
+{
+	DoorControl_StateType state;
+	DoorControl_EventType event;
+	DoorControl_StateType next_state;
+	DoorControl_StateType (*action)(DoorControl_StateType next_state);
+}DoorControl_TransitionType;
+
+typedef struct
+{
+	void (*entry)(void);
+	void (*exit)(void);
+	uint32 timeout_ms;		/* DOOR_CONTROL_TIMEOUT event after this time in the state */
+}DoorControl_StateDescType;
+
+static DoorControl_StateType g_door_control_state = DOOR_CONTROL_NEW_PASSWORD;
+static Tick_Type g_door_control_state_entry_tick = 0;
+static boolean g_door_control_is_moving = FALSE;
+/* status already pushed to the HMI ECU */
+static uint8 g_door_control_reported_progress = 0;
+static boolean g_door_control_is_people_reported = FALSE;
+/* last event of a door cycle, sent again until the panel takes it */
+static boolean g_door_control_is_final_waiting = FALSE;
+static uint8 g_door_control_final_address = DOOR_STATUS_NO_PANEL;
+static uint8 g_door_control_final_type = 0;
+static uint8 g_door_control_final_payload = 0;
+static uint8 g_door_control_final_length = 0;
+static uint8 g_door_control_final_id = LINK_NO_ID;
+/* the last close was reversed, and how many closes in a row the motor current stopped */
+static boolean g_door_control_is_reopened = FALSE;
+static uint8 g_door_control_obstructions = 0;
+
+/* link request being handled and whether an action answered it */
+static Link_MessageType g_door_control_request;
+static boolean g_door_control_is_replied = FALSE;
+/* link address of the HMI panel holding the door session, the events go to it */
+static uint8 g_door_control_panel = DOOR_STATUS_NO_PANEL;
+/* door status broadcast last to the HMI panels */
+static uint8 g_door_control_broadcast_status[DOOR_STATUS_SIZE];
+static Tick_Type g_door_control_broadcast_tick = 0;
+static uint8 g_door_control_password_size = 0;
+
+/******************************************************
+ * 				Entry, Exit and Transition Actions
+ ******************************************************/
+/*
+ * answers the link request that caused the running transition
+ */
+static void DoorControl_reply(const uint8* payload_Ptr, uint8 length)
+{
+	Link_sendReply(&g_door_control_request, payload_Ptr, length);
+	g_door_control_is_replied = TRUE;
+}
+
+/*
+ * pushes a status event to the panel holding the session, nobody is
+ * waiting for it once the session is over. Returns LINK_NO_ID if it was
+ * not queued
+ */
+static uint8 DoorControl_sendEvent(uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	if(g_door_control_panel == DOOR_STATUS_NO_PANEL)
+	{
+		return LINK_NO_ID;
+	}
+	return Link_sendEventTo(g_door_control_panel, type, payload_Ptr, length);
+}
+
+/*
+ * whether the panel at the given address still hears this ECU, a node
+ * only has the master to hear
+ */
+static boolean DoorControl_isPanelUp(uint8 address)
+{
+	Link_NodeStatusType panel_status;
+	if(Link_getNodeStatus(address, &panel_status) == TRUE)
+	{
+		return panel_status.is_up;
+	}
+	return Link_isUp();
+}
+
+/*
+ * forgets the last event of the door cycle, also on the link
+ */
+static void DoorControl_dropFinalEvent(void)
+{
+	if(g_door_control_final_id != LINK_NO_ID)
+	{
+		Link_cancel(g_door_control_final_id);
+		g_door_control_final_id = LINK_NO_ID;
+	}
+	g_door_control_is_final_waiting = FALSE;
+}
+
+/*
+ * sends the last event of the door cycle until the panel acknowledges it,
+ * a resync or the panel leaving the bus drops it, the sync reply then
+ * tells where the door is
+ */
+static void DoorControl_serviceFinalEvent(void)
+{
+	Link_MessageType acknowledge;
+	if(g_door_control_is_final_waiting == FALSE)
+	{
+		return;
+	}
+	if(g_door_control_final_id != LINK_NO_ID)
+	{
+		switch(Link_getResult(g_door_control_final_id, &acknowledge))
+		{
+		case LINK_PENDING:
+			return;
+		case LINK_DONE:
+			g_door_control_final_id = LINK_NO_ID;
+			g_door_control_is_final_waiting = FALSE;
+			return;
+		default:
+			g_door_control_final_id = LINK_NO_ID;
+			break;
+		}
+	}
+	if(DoorControl_isPanelUp(g_door_control_final_address) == FALSE)
+	{
+		g_door_control_is_final_waiting = FALSE;
+		return;
+	}
+	g_door_control_final_id = Link_sendTrackedEventTo(g_door_control_final_address, g_door_control_final_type,
+			&g_door_control_final_payload, g_door_control_final_length);
+}
+
+/*
+ * queues the event ending the door cycle, a terminal event lost on the
+ * link would leave the panel waiting for the door
+ */
+static void DoorControl_sendFinalEvent(uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	DoorControl_dropFinalEvent(); /* the newer event ends the cycle */
+	if(g_door_control_panel == DOOR_STATUS_NO_PANEL)
+	{
+		return;
+	}
+	g_door_control_is_final_waiting = TRUE;
+	g_door_control_final_address = g_door_control_panel;
+	g_door_control_final_type = type;
+	g_door_control_final_payload = (length > 0) ? payload_Ptr[0] : 0;
+	g_door_control_final_length = (length > 0) ? 1 : 0;
+	DoorControl_serviceFinalEvent();
+}
+
+/*
+ * copies a password out of the request payload up to the string break,
+ * returns the index following the break
+ */
+static uint8 DoorControl_copyPassword(uint8* password, uint8 payload_index)
+{
+	uint8 password_index = 0;
+	while((payload_index < g_door_control_request.length) &&
+			(g_door_control_request.payload[payload_index] != UART_RX_STRING_BREAK))
+	{
+		/* characters past the longest password are dropped so the compare fails */
+		if(password_index < (DOOR_CONTROL_PASSWORD_SIZE - 1))
+		{
+			password[password_index++] = g_door_control_request.payload[payload_index];
+		}
+		payload_index++;
+	}
+	password[password_index] = '\0';
+	return (uint8)(payload_index + 1);
+}
+
+/*
+ * tells the HMI ECU that the door move was aborted by the motor protection
+ * and re-arms the motor for the next request
+ */
+static void DoorControl_reportMotorFault(void)
+{
+	DoorControl_sendFinalEvent(DOOR_MOTOR_FAULT_ID, NULL_PTR, 0);
+	DcMotor_clearFault();
+}
+
+/*
+ * tells the HMI ECU that the close was reversed and how long the reversal took
+ */
+static void DoorControl_reportReopenLatency(void)
+{
+	uint32 latency_us;
+	uint32 latency_ms;
+	uint8 reported_latency_ms;
+	if(DoorGuard_getReopenLatency(&latency_us) == TRUE)
+	{
+		latency_ms = (latency_us + 500UL) / 1000UL;
+		if(latency_ms > DOOR_GUARD_MAX_REPORTED_LATENCY_MS)
+		{
+			latency_ms = DOOR_GUARD_MAX_REPORTED_LATENCY_MS;
+		}
+		reported_latency_ms = (uint8)latency_ms;
+		DoorControl_sendEvent(DOOR_REOPEN_ID, &reported_latency_ms, 1);
+		g_door_control_reported_progress = 0; /* the reopen is reported as a new opening move */
+	}
+}
+
+/*
+ * pushes the door status to the HMI ECU as it changes, the HMI ECU has no
+ * door timing of its own and only renders these events
+ */
+static void DoorControl_reportStatus(void)
+{
+	uint8 progress;
+	uint8 status_type;
+
+	if((g_door_control_state == DOOR_CONTROL_OPENING) || (g_door_control_state == DOOR_CONTROL_CLOSING))
+	{
+		if(g_door_control_is_moving == FALSE)
+		{
+			return;
+		}
+		progress = DoorTravel_getProgress();
+		if(progress >= (g_door_control_reported_progress + DOOR_CONTROL_PROGRESS_STEP_PERCENT))
+		{
+			status_type = ((g_door_control_state == DOOR_CONTROL_OPENING) || (DoorGuard_isReopened() == TRUE)) ?
+					OPEN_DOOR_STATE_ID : CLOSE_DOOR_STATE_ID;
+			/* a progress not queued is tried again on the next dispatch */
+			if(DoorControl_sendEvent(status_type, &progress, 1) != LINK_NO_ID)
+			{
+				g_door_control_reported_progress = progress;
+			}
+		}
+	}
+	else if(g_door_control_state == DOOR_CONTROL_OPEN_WAITING)
+	{
+		if((g_door_control_is_people_reported == FALSE) && (PIR_isOccupied() == TRUE) &&
+				(DoorControl_sendEvent(PEOPLE_PASS_THROUGH_ID, NULL_PTR, 0) != LINK_NO_ID))
+		{
+			g_door_control_is_people_reported = TRUE;
+		}
+	}
+}
+
+/*
+ * the state id the HMI ECU resumes in after a sync, also part of the node status
+ */
+static uint8 DoorControl_getSyncId(DoorControl_StateType state)
+{
+	switch(state)
+	{
+	case DOOR_CONTROL_NEW_PASSWORD:
+		return SYNC_NEW_PASSWORD_ID;
+	case DOOR_CONTROL_OPENING:
+	case DOOR_CONTROL_OPEN_WAITING:
+	case DOOR_CONTROL_CLOSING:
+		return SYNC_DOOR_BUSY_ID;
+	case DOOR_CONTROL_LOCKOUT:
+		return SYNC_LOCKOUT_ID;
+	default:
+		return SYNC_IDLE_ID;
+	}
+}
+
+/*
+ * refreshes the status the HMI ECU polls, on a bus it watches every door with
+ * it. When this ECU is the master of several HMI panels the status is also
+ * broadcast so the panels out of session show whether the door is free
+ */
+static void DoorControl_updateStatus(void)
+{
+	uint8 door_status[DOOR_STATUS_SIZE];
+	uint8 byte_index;
+	door_status[DOOR_STATUS_STATE_INDEX] = DoorControl_getSyncId(g_door_control_state);
+	door_status[DOOR_STATUS_PROGRESS_INDEX] = (g_door_control_is_moving == TRUE) ? DoorTravel_getProgress() : 0;
+	door_status[DOOR_STATUS_PANEL_INDEX] = g_door_control_panel;
+	Link_setStatus(door_status, LINK_NODE_STATUS_SIZE);
+
+	if((door_status[DOOR_STATUS_STATE_INDEX] != g_door_control_broadcast_status[DOOR_STATUS_STATE_INDEX]) ||
+			(door_status[DOOR_STATUS_PANEL_INDEX] != g_door_control_broadcast_status[DOOR_STATUS_PANEL_INDEX]) ||
+			(Tick_elapsedSince(g_door_control_broadcast_tick) >= DOOR_CONTROL_STATUS_PERIOD_MS))
+	{
+		for(byte_index = 0; byte_index < DOOR_STATUS_SIZE; byte_index++)
+		{
+			g_door_control_broadcast_status[byte_index] = door_status[byte_index];
+		}
+		g_door_control_broadcast_tick = Tick_getTicks();
+		Link_broadcast(DOOR_STATUS_ID, door_status, DOOR_STATUS_SIZE);
+	}
+}
+
+/*
+ * pushes the start of a move with no progress yet
+ */
+static void DoorControl_reportMoveStart(uint8 status_type)
+{
+	uint8 progress = 0;
+	g_door_control_reported_progress = 0;
+	DoorControl_sendEvent(status_type, &progress, 1);
+}
+
+/*
+ * entered on the open request which is answered here
+ */
+static void DoorControl_enterOpening(void)
+{
+	DoorControl_reply(NULL_PTR, 0);
+	DoorControl_dropFinalEvent(); /* the panel asked for a new cycle so it is done with the last one */
+	g_door_control_is_reopened = FALSE;
+	g_door_control_obstructions = 0;
+	DoorControl_reportMoveStart(OPEN_DOOR_STATE_ID);
+	DoorTravel_startMove(CW); /* Opening the door, stops early on arrival */
+	g_door_control_is_moving = TRUE;
+}
+
+static void DoorControl_enterOpenWaiting(void)
+{
+	uint8 is_door_open = TRUE;
+	DoorControl_sendFinalEvent(OPEN_CLOSE_DOOR_DONE, &is_door_open, 1);
+	g_door_control_is_people_reported = FALSE;
+}
+
+/*
+ * the guard reopens the door from the tick if the doorway is blocked
+ */
+static void DoorControl_enterClosing(void)
+{
+	DoorControl_reportMoveStart(CLOSE_DOOR_STATE_ID);
+	g_door_control_is_reopened = FALSE;
+	Buzzer_playPattern(BUZZER_PATTERN_DOOR_WARNING); /* chirps while the door closes */
+	DoorGuard_armClose();
+	DoorTravel_startMove(ACW);
+	g_door_control_is_moving = TRUE;
+}
+
+static void DoorControl_exitClosing(void)
+{
+	DoorGuard_disarm();
+	Buzzer_off();
+}
+
+static void DoorControl_enterLockout(void)
+{
+	Buzzer_playPattern(BUZZER_PATTERN_ALARM);
+}
+
+static void DoorControl_exitLockout(void)
+{
+	Buzzer_off();
+}
+
+/*
+ * the request carries the new password and its confirmation, they must
+ * match before the password is stored in the EEPROM
+ */
+static DoorControl_StateType DoorControl_storeNewPassword(DoorControl_StateType next_state)
+{
+	uint8 password[DOOR_CONTROL_PASSWORD_SIZE], re_password[DOOR_CONTROL_PASSWORD_SIZE];
+	uint8 reply = CORRECT_PASSCODE_ID;
+
+	DoorControl_copyPassword(re_password, DoorControl_copyPassword(password, 0));
+	if(strcmp((char*)password, (char*)re_password))
+	{
+		reply = FALSE_PASSCODE_ID;
+		DoorControl_reply(&reply, 1);
+		return next_state;
+	}
+	g_door_control_password_size = 0;
+	EEPROM_writeByteStream(DOOR_CONTROL_PASSWORD_EEPROM_ADDRESS, password, &g_door_control_password_size);
+	DoorControl_reply(&reply, 1); /* after storing so a login right after it sees the new password */
+	return DOOR_CONTROL_IDLE;
+}
+
+/*
+ * sign-in attempt check for equality between login attempted and password stored in eeprom
+ */
+static DoorControl_StateType DoorControl_checkLogin(DoorControl_StateType next_state)
+{
+	uint8 saved_password[DOOR_CONTROL_PASSWORD_SIZE], login_attempt[DOOR_CONTROL_PASSWORD_SIZE];
+	uint8 password_length, reply;
+
+	Buzzer_playPattern(BUZZER_PATTERN_KEY_CLICK); /* acknowledging the entered password */
+	password_length = EEPROM_readByteStream(DOOR_CONTROL_PASSWORD_EEPROM_ADDRESS, saved_password, g_door_control_password_size);
+	saved_password[password_length] = '\0';
+
+	DoorControl_copyPassword(login_attempt, 0);
+
+	if(!strcmp((char*)saved_password, (char*)login_attempt))
+	{
+		reply = CORRECT_PASSCODE_ID; /* telling the HMI ECU that the password is correct */
+		next_state = DOOR_CONTROL_AUTHORIZED;
+	}
+	else
+	{
+		reply = FALSE_PASSCODE_ID; /* telling the HMI ECU that the password is incorrect */
+		next_state = DOOR_CONTROL_REJECTED;
+	}
+	DoorControl_reply(&reply, 1);
+	return next_state;
+}
+
+static DoorControl_StateType DoorControl_finishOpening(DoorControl_StateType next_state)
+{
+	if(DoorTravel_finishMove() == FALSE)
+	{
+		DoorControl_reportMotorFault();
+		return DOOR_CONTROL_IDLE;
+	}
+	return next_state;
+}
+
+/*
+ * after a reversed close the doorway is given the hold-off time before the
+ * door closes again
+ */
+static DoorControl_StateType DoorControl_startClosing(DoorControl_StateType next_state)
+{
+	if((g_door_control_is_reopened == TRUE) &&
+			(Tick_elapsedSince(g_door_control_state_entry_tick) < DOOR_CONTROL_REOPEN_HOLD_OFF_MS))
+	{
+		return DOOR_CONTROL_OPEN_WAITING;
+	}
+	return next_state;
+}
+
+/*
+ * a reversed close waits for the doorway to clear and starts over, a door
+ * the motor current keeps stopping is left open and reported as a fault
+ */
+static DoorControl_StateType DoorControl_finishClosing(DoorControl_StateType next_state)
+{
+	uint8 is_door_open;
+	DoorControl_reportReopenLatency(); /* a reopen may finish on the last tick */
+	if(DoorTravel_finishMove() == FALSE)
+	{
+		DoorControl_reportMotorFault();
+		return DOOR_CONTROL_IDLE;
+	}
+	if(DoorGuard_isReopened() == TRUE)
+	{
+		g_door_control_is_reopened = TRUE;
+		if(DoorGuard_getLastCause() == DOOR_GUARD_CURRENT_OBSTRUCTION)
+		{
+			g_door_control_obstructions++;
+			if(g_door_control_obstructions >= DOOR_CONTROL_MAX_OBSTRUCTIONS)
+			{
+				DoorControl_reportMotorFault();
+				return DOOR_CONTROL_IDLE;
+			}
+		}
+		return DOOR_CONTROL_OPEN_WAITING;
+	}
+	g_door_control_obstructions = 0;
+	is_door_open = FALSE;
+	DoorControl_sendFinalEvent(OPEN_CLOSE_DOOR_DONE, &is_door_open, 1);
+	return next_state;
+}
+
+/*
+ * the HMI ECU lost its state, the login and password steps start over while
+ * a running door cycle and the lockout carry on, the reply tells the HMI
+ * ECU where the state machine resumed
+ */
+static DoorControl_StateType DoorControl_resync(DoorControl_StateType next_state)
+{
+	uint8 reply[2];
+	uint32 lockout_left_ms = Tick_elapsedSince(g_door_control_state_entry_tick);
+
+	DoorControl_dropFinalEvent(); /* the reply tells where the door is */
+	switch(next_state)
+	{
+	case DOOR_CONTROL_OPENING:
+	case DOOR_CONTROL_OPEN_WAITING:
+	case DOOR_CONTROL_CLOSING:
+		reply[0] = DoorControl_getSyncId(next_state);
+		DoorControl_reply(reply, 1);
+		break;
+	case DOOR_CONTROL_LOCKOUT:
+		/* the timeout may be due but not dispatched yet */
+		lockout_left_ms = (lockout_left_ms < DOOR_CONTROL_LOCKOUT_TIME_MS) ? (DOOR_CONTROL_LOCKOUT_TIME_MS - lockout_left_ms) : 0;
+		reply[0] = DoorControl_getSyncId(next_state);
+		reply[1] = (uint8)((lockout_left_ms + 999UL) / 1000UL);
+		DoorControl_reply(reply, 2);
+		break;
+	default:
+		/* a password change cancelled half way keeps the stored password */
+		next_state = (g_door_control_password_size == 0) ? DOOR_CONTROL_NEW_PASSWORD : DOOR_CONTROL_IDLE;
+		reply[0] = DoorControl_getSyncId(next_state);
+		DoorControl_reply(reply, 1);
+		break;
+	}
+	return next_state;
+}
+
+/*
+ * the move did not end in time, the motor is stopped and the move reported as failed
+ */
+static DoorControl_StateType DoorControl_abortMove(DoorControl_StateType next_state)
+{
+	DcMotor_haltProfile();
+	g_door_control_is_moving = FALSE;
+	DoorControl_reportMotorFault();
+	return next_state;
+}
+
+/******************************************************
+ * 					Tables
+ ******************************************************/
+static const DoorControl_StateDescType g_door_control_states[DOOR_CONTROL_NUM_OF_STATES] PROGMEM =
+{
+	/* DOOR_CONTROL_NEW_PASSWORD */	{NULL_PTR, NULL_PTR, DOOR_CONTROL_NO_TIMEOUT},
+	/* DOOR_CONTROL_IDLE */			{NULL_PTR, NULL_PTR, DOOR_CONTROL_NO_TIMEOUT},
+	/* DOOR_CONTROL_AUTHORIZED */		{NULL_PTR, NULL_PTR, DOOR_CONTROL_NO_TIMEOUT},
+	/* DOOR_CONTROL_REJECTED */		{NULL_PTR, NULL_PTR, DOOR_CONTROL_NO_TIMEOUT},
+	/* DOOR_CONTROL_OPENING */		{DoorControl_enterOpening, NULL_PTR, DOOR_CONTROL_MOVE_TIMEOUT_MS},
+	/* DOOR_CONTROL_OPEN_WAITING */	{DoorControl_enterOpenWaiting, NULL_PTR, DOOR_CONTROL_NO_TIMEOUT},
+	/* DOOR_CONTROL_CLOSING */		{DoorControl_enterClosing, DoorControl_exitClosing, DOOR_CONTROL_MOVE_TIMEOUT_MS},
+	/* DOOR_CONTROL_LOCKOUT */		{DoorControl_enterLockout, DoorControl_exitLockout, DOOR_CONTROL_LOCKOUT_TIME_MS}
+};
+
+/*
+ * Events without a row are ignored in that state, the redundant attempts
+ * status sent after a correct password only gets its empty reply
+ */
+static const DoorControl_TransitionType g_door_control_transitions[] PROGMEM =
+{
+	{DOOR_CONTROL_NEW_PASSWORD,		DOOR_CONTROL_SET_PASSWORD,		DOOR_CONTROL_NEW_PASSWORD,	DoorControl_storeNewPassword},
+	{DOOR_CONTROL_IDLE,				DOOR_CONTROL_LOGIN,				DOOR_CONTROL_IDLE,			DoorControl_checkLogin},
+	{DOOR_CONTROL_AUTHORIZED,		DOOR_CONTROL_OPEN_REQUEST,		DOOR_CONTROL_OPENING,		NULL_PTR},
+	{DOOR_CONTROL_AUTHORIZED,		DOOR_CONTROL_CHANGE_PASSWORD,	DOOR_CONTROL_NEW_PASSWORD,	NULL_PTR},
+	{DOOR_CONTROL_REJECTED,			DOOR_CONTROL_SYSTEM_OK,			DOOR_CONTROL_IDLE,			NULL_PTR},
+	{DOOR_CONTROL_REJECTED,			DOOR_CONTROL_SYSTEM_NOK,		DOOR_CONTROL_LOCKOUT,		NULL_PTR},
+	{DOOR_CONTROL_OPENING,			DOOR_CONTROL_MOVE_DONE,			DOOR_CONTROL_OPEN_WAITING,	DoorControl_finishOpening},
+	{DOOR_CONTROL_OPENING,			DOOR_CONTROL_TIMEOUT,			DOOR_CONTROL_IDLE,			DoorControl_abortMove},
+	{DOOR_CONTROL_OPEN_WAITING,		DOOR_CONTROL_DOORWAY_CLEAR,		DOOR_CONTROL_CLOSING,		DoorControl_startClosing},
+	{DOOR_CONTROL_CLOSING,			DOOR_CONTROL_MOVE_DONE,			DOOR_CONTROL_IDLE,			DoorControl_finishClosing},
+	{DOOR_CONTROL_CLOSING,			DOOR_CONTROL_TIMEOUT,			DOOR_CONTROL_IDLE,			DoorControl_abortMove},
+	{DOOR_CONTROL_LOCKOUT,			DOOR_CONTROL_TIMEOUT,			DOOR_CONTROL_IDLE,			NULL_PTR},
+	{DOOR_CONTROL_NEW_PASSWORD,		DOOR_CONTROL_SYNC,				DOOR_CONTROL_NEW_PASSWORD,	DoorControl_resync},
+	{DOOR_CONTROL_IDLE,				DOOR_CONTROL_SYNC,				DOOR_CONTROL_IDLE,			DoorControl_resync},
+	{DOOR_CONTROL_AUTHORIZED,		DOOR_CONTROL_SYNC,				DOOR_CONTROL_IDLE,			DoorControl_resync},
+	{DOOR_CONTROL_REJECTED,			DOOR_CONTROL_SYNC,				DOOR_CONTROL_IDLE,			DoorControl_resync},
+	{DOOR_CONTROL_OPENING,			DOOR_CONTROL_SYNC,				DOOR_CONTROL_OPENING,		DoorControl_resync},
+	{DOOR_CONTROL_OPEN_WAITING,		DOOR_CONTROL_SYNC,				DOOR_CONTROL_OPEN_WAITING,	DoorControl_resync},
+	{DOOR_CONTROL_CLOSING,			DOOR_CONTROL_SYNC,				DOOR_CONTROL_CLOSING,		DoorControl_resync},
+	{DOOR_CONTROL_LOCKOUT,			DOOR_CONTROL_SYNC,				DOOR_CONTROL_LOCKOUT,		DoorControl_resync}
+};
+
+#define DOOR_CONTROL_NUM_OF_TRANSITIONS		(sizeof(g_door_control_transitions) / sizeof(g_door_control_transitions[0]))
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Description:
+ * Runs the exit action of the current state and the entry action of the next one
+ */
+static void DoorControl_changeState(DoorControl_StateType next_state)
+{
+	void (*state_action)(void);
+
+	state_action = (void(*)(void))pgm_read_ptr(&g_door_control_states[g_door_control_state].exit);
+	if(state_action != NULL_PTR)
+	{
+		(*state_action)();
+	}
+	g_door_control_state = next_state;
+	g_door_control_state_entry_tick = Tick_getTicks();
+	state_action = (void(*)(void))pgm_read_ptr(&g_door_control_states[next_state].entry);
+	if(state_action != NULL_PTR)
+	{
+		(*state_action)();
+	}
+}
+
+/*
+ * Description:
+ * Turns a link request type into an event
+ */
+static DoorControl_EventType DoorControl_requestToEvent(uint8 request_type)
+{
+	switch(request_type)
+	{
+	case SET_PASSWORD_ID:
+		return DOOR_CONTROL_SET_PASSWORD;
+	case LOGIN_ID:
+		return DOOR_CONTROL_LOGIN;
+	case SYSTEM_OK_ID:
+		return DOOR_CONTROL_SYSTEM_OK;
+	case SYSTEM_NOK_ID:
+		return DOOR_CONTROL_SYSTEM_NOK;
+	case DOOR_OPEN_ID:
+		return DOOR_CONTROL_OPEN_REQUEST;
+	case CHANGE_PASSWORD_ID:
+		return DOOR_CONTROL_CHANGE_PASSWORD;
+	case UART_SYNC_CHAR:
+		return DOOR_CONTROL_SYNC;
+	default:
+		return DOOR_CONTROL_NO_EVENT;
+	}
+}
+
+/*
+ * Description:
+ * Returns the most urgent pending event, link requests first so the HMI
+ * is answered in every state
+ */
+static DoorControl_EventType DoorControl_getEvent(void)
+{
+	uint32 timeout_ms;
+	uint8 reply = PANEL_BUSY_ID;
+
+	Link_poll();
+	if(Link_receive(&g_door_control_request) == TRUE)
+	{
+		g_door_control_is_replied = FALSE;
+		if(g_door_control_panel == DOOR_STATUS_NO_PANEL)
+		{
+			g_door_control_panel = g_door_control_request.address;
+		}
+		else if(g_door_control_request.address != g_door_control_panel)
+		{
+			/* the contention is settled by this one reply */
+			DoorControl_reply(&reply, 1);
+			return DOOR_CONTROL_NO_EVENT;
+		}
+		return DoorControl_requestToEvent(g_door_control_request.type);
+	}
+	g_door_control_request.kind = LINK_REPLY; /* no request behind the event */
+
+	if((g_door_control_is_moving == TRUE) && (DoorTravel_isMoving() == FALSE))
+	{
+		g_door_control_is_moving = FALSE;
+		return DOOR_CONTROL_MOVE_DONE;
+	}
+
+	timeout_ms = pgm_read_dword(&g_door_control_states[g_door_control_state].timeout_ms);
+	if((timeout_ms != DOOR_CONTROL_NO_TIMEOUT) && (Tick_elapsedSince(g_door_control_state_entry_tick) >= timeout_ms))
+	{
+		return DOOR_CONTROL_TIMEOUT;
+	}
+
+	/* a sensor stuck high times out in the PIR tracker so the door can still close */
+	if(PIR_isOccupied() == FALSE)
+	{
+		return DOOR_CONTROL_DOORWAY_CLEAR;
+	}
+	return DOOR_CONTROL_NO_EVENT;
+}
+
+/*
+ * Description:
+ * Ends the session of a panel that left the bus so another one can take
+ * the door, the login or password steps it left half way start over as on
+ * a resync
+ */
+static void DoorControl_checkPanel(void)
+{
+	Link_NodeStatusType panel_status;
+	if((Link_getNodeStatus(g_door_control_panel, &panel_status) == TRUE) && (panel_status.is_up == FALSE))
+	{
+		g_door_control_panel = DOOR_STATUS_NO_PANEL;
+		if((g_door_control_state == DOOR_CONTROL_AUTHORIZED) || (g_door_control_state == DOOR_CONTROL_REJECTED) ||
+				((g_door_control_state == DOOR_CONTROL_NEW_PASSWORD) && (g_door_control_password_size != 0)))
+		{
+			DoorControl_changeState(DOOR_CONTROL_IDLE);
+		}
+	}
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void DoorControl_init(void)
+{
+	g_door_control_state = DOOR_CONTROL_NEW_PASSWORD;
+	g_door_control_state_entry_tick = Tick_getTicks();
+	g_door_control_is_moving = FALSE;
+	g_door_control_panel = DOOR_STATUS_NO_PANEL;
+	g_door_control_broadcast_tick = Tick_getTicks();
+}
+
+void DoorControl_dispatch(void)
+{
+	DoorControl_EventType event;
+	DoorControl_StateType next_state;
+	DoorControl_StateType (*transition_action)(DoorControl_StateType);
+	uint8 transition_index;
+
+	/* status and diagnostics are serviced whatever the state */
+	DoorTravel_service();
+	DoorControl_serviceFinalEvent();
+	DoorControl_reportReopenLatency();
+	DoorControl_reportStatus();
+	DoorControl_checkPanel();
+	DoorControl_updateStatus();
+
+	event = DoorControl_getEvent();
+
+	for(transition_index = 0; transition_index < DOOR_CONTROL_NUM_OF_TRANSITIONS; transition_index++)
+	{
+		if((pgm_read_byte(&g_door_control_transitions[transition_index].state) == g_door_control_state) &&
+				(pgm_read_byte(&g_door_control_transitions[transition_index].event) == event))
+		{
+			next_state = (DoorControl_StateType)pgm_read_byte(&g_door_control_transitions[transition_index].next_state);
+			transition_action = (DoorControl_StateType(*)(DoorControl_StateType))pgm_read_ptr(&g_door_control_transitions[transition_index].action);
+			if(transition_action != NULL_PTR)
+			{
+				next_state = (*transition_action)(next_state);
+			}
+			/* staying in the same state is an internal transition, no exit or entry */
+			if(next_state != g_door_control_state)
+			{
+				DoorControl_changeState(next_state);
+			}
+			break;
+		}
+	}
+
+	if((g_door_control_request.kind == LINK_REQUEST) && (g_door_control_is_replied == FALSE))
+	{
+		DoorControl_reply(NULL_PTR, 0);
+	}
+
+	/*
+	 * the session is over once the state machine waits for a login again, a
+	 * password change keeps it and only the first password is open to any panel
+	 */
+	if((g_door_control_state == DOOR_CONTROL_IDLE) ||
+			((g_door_control_state == DOOR_CONTROL_NEW_PASSWORD) && (g_door_control_password_size == 0)))
+	{
+		g_door_control_panel = DOOR_STATUS_NO_PANEL;
+	}
+}
+
+DoorControl_StateType DoorControl_getState(void)
+{
+	return g_door_control_state;
+}
@@ -0,0 +1,94 @@
+/*
+ *  File: Header file for Door control state machine
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef DOOR_CONTROL_H_
+#define DOOR_CONTROL_H_
+
+#include "std_types.h"
+#include "door_lock_states.h"
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+typedef enum
+{
+	DOOR_CONTROL_NEW_PASSWORD,		/* waiting for the password and its confirmation */
+	DOOR_CONTROL_IDLE,				/* door closed, waiting for a login attempt */
+	DOOR_CONTROL_AUTHORIZED,		/* login accepted, waiting for the operator request */
+	DOOR_CONTROL_REJECTED,			/* login refused, waiting for the HMI attempts status */
+	DOOR_CONTROL_OPENING,
+	DOOR_CONTROL_OPEN_WAITING,		/* door open, waiting for the doorway to clear */
+	DOOR_CONTROL_CLOSING,
+	DOOR_CONTROL_LOCKOUT,
+	DOOR_CONTROL_NUM_OF_STATES
+}DoorControl_StateType;
+
+typedef enum
+{
+	DOOR_CONTROL_NO_EVENT,
+	DOOR_CONTROL_SET_PASSWORD,		/* new password and its confirmation */
+	DOOR_CONTROL_LOGIN,
+	DOOR_CONTROL_SYSTEM_OK,			/* HMI attempts status 'K' */
+	DOOR_CONTROL_SYSTEM_NOK,		/* HMI attempts status 'W' */
+	DOOR_CONTROL_OPEN_REQUEST,
+	DOOR_CONTROL_CHANGE_PASSWORD,
+	DOOR_CONTROL_MOVE_DONE,			/* the running door move ended */
+	DOOR_CONTROL_DOORWAY_CLEAR,
+	DOOR_CONTROL_TIMEOUT,			/* the current state timeout expired */
+	DOOR_CONTROL_SYNC				/* the HMI ECU booted or the link resynced */
+}DoorControl_EventType;
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+#define DOOR_CONTROL_LOCKOUT_TIME_MS		60000UL
+#define DOOR_CONTROL_MOVE_TIMEOUT_MS		DOOR_MOVE_TIMEOUT_MS
+#define DOOR_CONTROL_NO_TIMEOUT				0UL
+/* a reversed close keeps the door open this long before closing again */
+#define DOOR_CONTROL_REOPEN_HOLD_OFF_MS		3000UL
+/* closes in a row stopped by the motor current before the door is reported jammed */
+#define DOOR_CONTROL_MAX_OBSTRUCTIONS		3u
+/* a move progress event is pushed each time the door covers this much */
+#define DOOR_CONTROL_PROGRESS_STEP_PERCENT	5u
+/* the door status is broadcast to the HMI panels on a change and at least this often */
+#define DOOR_CONTROL_STATUS_PERIOD_MS		1000u
+
+/* longest password plus its terminator */
+#define DOOR_CONTROL_PASSWORD_SIZE			6u
+#define DOOR_CONTROL_PASSWORD_EEPROM_ADDRESS	0x0200u
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Starts the state machine waiting for the first password, the link and
+ * the door modules must already be initialized. The HMI ECU syncs with
+ * the state machine through its sync request
+ */
+void DoorControl_init(void);
+
+/*
+ * Description:
+ * Takes the next pending event (link request, motion, sensor or timeout)
+ * and runs its transition, never blocks on the door phase so it is
+ * called continuously from the main loop. Every link request is answered,
+ * requests not expected in the current state get an empty reply.
+ * The first HMI panel to send a request out of IDLE holds the door session
+ * until the state machine is back waiting for a login, the requests of
+ * the other panels meanwhile get the busy reply
+ */
+void DoorControl_dispatch(void);
+
+/*
+ * Description:
+ * Returns the current state
+ */
+DoorControl_StateType DoorControl_getState(void);
+
+#endif /* DOOR_CONTROL_H_ */
@@ -0,0 +1,141 @@
+/*
+ *  File: Source file for Door closing obstruction guard
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "door_guard.h"
+#include "door_travel.h"
+#include "door_position.h"
+#include "dcmotor_profile.h"
+#include "pir.h"
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile boolean g_guard_is_armed = FALSE;
+static volatile boolean g_guard_is_reopening = FALSE;
+static volatile boolean g_guard_has_reopened = FALSE;
+static volatile boolean g_guard_is_latency_ready = FALSE;
+static volatile DoorGuard_CauseType g_guard_last_cause = DOOR_GUARD_NO_OBSTRUCTION;
+static volatile Tick_Type g_guard_close_start_tick = 0;
+static volatile uint32 g_guard_detect_us = 0;
+static volatile uint32 g_guard_latency_us = 0;
+static volatile uint32 g_guard_max_latency_us = 0;
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Runs every tick after the PIR tracker and the motor hooks, so an
+ * obstruction is acted on in the same tick it is seen
+ */
+static void DoorGuard_tickHook(void)
+{
+	DoorGuard_CauseType cause = DOOR_GUARD_NO_OBSTRUCTION;
+
+	if(g_guard_is_armed == FALSE)
+	{
+		return;
+	}
+
+	if(g_guard_is_reopening == TRUE)
+	{
+		/* the reversal waits for the bridge dead time, the latency ends when it drives open */
+		if(DcMotor_getState() == DOOR_POSITION_OPEN_DIRECTION)
+		{
+			g_guard_latency_us = Tick_getMicros() - g_guard_detect_us;
+			if(g_guard_latency_us > g_guard_max_latency_us)
+			{
+				g_guard_max_latency_us = g_guard_latency_us;
+			}
+			g_guard_is_latency_ready = TRUE;
+			g_guard_is_reopening = FALSE;
+			g_guard_is_armed = FALSE; /* the next close arms the guard again */
+		}
+		return;
+	}
+
+	/* the stall trip already stopped the motor, unless it is the door reaching its end stop */
+	if((DcMotor_getFault() == DC_MOTOR_STALL) && (DoorTravel_isNearEnd() == FALSE))
+	{
+		cause = DOOR_GUARD_CURRENT_OBSTRUCTION;
+		DcMotor_clearFault();
+	}
+	else if((DcMotor_isMoving() == TRUE) && (PIR_isOccupied() == TRUE))
+	{
+		cause = DOOR_GUARD_PIR_OBSTRUCTION;
+	}
+
+	if(cause != DOOR_GUARD_NO_OBSTRUCTION)
+	{
+		g_guard_detect_us = Tick_getMicros();
+		g_guard_last_cause = cause;
+		g_guard_is_reopening = TRUE;
+		g_guard_has_reopened = TRUE;
+		/* brakes at once and drives open after the dead time */
+		DoorTravel_startReopen(Tick_elapsedSince(g_guard_close_start_tick));
+	}
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void DoorGuard_init(void)
+{
+	Tick_addHook(DoorGuard_tickHook);
+}
+
+void DoorGuard_armClose(void)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	g_guard_close_start_tick = Tick_getTicks();
+	g_guard_is_reopening = FALSE;
+	g_guard_is_latency_ready = FALSE;
+	g_guard_has_reopened = FALSE;
+	g_guard_is_armed = TRUE;
+	SREG = sreg_value;
+}
+
+void DoorGuard_disarm(void)
+{
+	g_guard_is_armed = FALSE;
+	g_guard_is_reopening = FALSE;
+}
+
+boolean DoorGuard_getReopenLatency(uint32* latency_us_Ptr)
+{
+	uint8 sreg_value;
+	if(g_guard_is_latency_ready == FALSE)
+	{
+		return FALSE;
+	}
+	sreg_value = SREG;
+	cli();
+	*latency_us_Ptr = g_guard_latency_us;
+	g_guard_is_latency_ready = FALSE;
+	SREG = sreg_value;
+	return TRUE;
+}
+
+boolean DoorGuard_isReopened(void)
+{
+	return g_guard_has_reopened;
+}
+
+DoorGuard_CauseType DoorGuard_getLastCause(void)
+{
+	return g_guard_last_cause;
+}
+
+uint32 DoorGuard_getMaxLatencyUs(void)
+{
+	uint32 max_latency_us;
+	uint8 sreg_value = SREG;
+	cli();
+	max_latency_us = g_guard_max_latency_us;
+	SREG = sreg_value;
+	return max_latency_us;
+}
@@ -0,0 +1,78 @@
+/*
+ *  File: Header file for Door closing obstruction guard
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef DOOR_GUARD_H_
+#define DOOR_GUARD_H_
+
+#include "std_types.h"
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+typedef enum
+{
+	DOOR_GUARD_NO_OBSTRUCTION,
+	DOOR_GUARD_PIR_OBSTRUCTION,			/* someone stepped into the doorway */
+	DOOR_GUARD_CURRENT_OBSTRUCTION		/* the motor stalled against something */
+}DoorGuard_CauseType;
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/* Reopen latency reported to the HMI ECU is saturated to one byte of milliseconds */
+#define DOOR_GUARD_MAX_REPORTED_LATENCY_MS		255u
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Attaches the guard to the system tick, PIR_init() and DoorPosition_init()
+ * must be called first so their tick hooks run before the guard
+ */
+void DoorGuard_init(void);
+
+/*
+ * Description:
+ * Starts watching the doorway, called just before the close move starts.
+ * On an obstruction the motor is braked and the door reopens from the tick
+ */
+void DoorGuard_armClose(void);
+
+/*
+ * Description:
+ * Stops watching the doorway once the close move has ended
+ */
+void DoorGuard_disarm(void);
+
+/*
+ * Description:
+ * Returns TRUE once per reopen with the time from obstruction detection to
+ * the motor driving in the open direction
+ */
+boolean DoorGuard_getReopenLatency(uint32* latency_us_Ptr);
+
+/*
+ * Description:
+ * Returns TRUE if the door was reversed since the last DoorGuard_armClose()
+ */
+boolean DoorGuard_isReopened(void);
+
+/*
+ * Description:
+ * Returns what caused the last reopen
+ */
+DoorGuard_CauseType DoorGuard_getLastCause(void);
+
+/*
+ * Description:
+ * Returns the longest reopen latency seen since power up
+ */
+uint32 DoorGuard_getMaxLatencyUs(void);
+
+#endif /* DOOR_GUARD_H_ */
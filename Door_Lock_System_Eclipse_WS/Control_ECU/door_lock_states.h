@@ -25,6 +25,8 @@
  * 'C': closing door
  * 'W': System shutdown warning
  * 'K': System reboot
+ * 'J': door motor stopped on over-current or stall
+ * 'R': door reopened on an obstruction while closing, followed by the latency in ms
  *******************************************/
 #define FALSE_PASSCODE_ID		'F'
 #define CORRECT_PASSCODE_ID		'T'
@@ -34,5 +36,59 @@
 #define OPEN_CLOSE_DOOR_DONE	'D'
 #define SYSTEM_NOK_ID			'W'
 #define SYSTEM_OK_ID			'K'
+#define DOOR_MOTOR_FAULT_ID		'J'
+#define DOOR_REOPEN_ID			'R'
+
+/*******************************************
+ * 			Link message types:
+ * requests from the HMI ECU, answered by the Control ECU
+ * 'A': sync, sent on boot and each time the link resyncs, the reply is the
+ *      state the Control ECU resumed in:
+ *      'N' waiting for the first password, 'I' door closed waiting for a login,
+ *      'B' door cycle running, its status events follow,
+ *      'X' system locked out followed by the seconds left
+ * 'P': new password '#' its confirmation, reply 'T' or 'F'
+ * 'L': login password, reply 'T' or 'F'
+ * 'K'/'W': attempts status after a login, empty reply
+ * '+': open the door, empty reply
+ * '-': change the password, empty reply
+ * any request may instead get the reply 'Y' when another HMI panel holds
+ * the door session, the panel waits for the 'U' broadcast to show it free
+ * status events pushed by the Control ECU, the HMI ECU only renders them
+ * 'O': opening door followed by the progress in percent
+ * 'C': closing door followed by the progress in percent
+ * 'D': door move done followed by TRUE if the door is open, FALSE if closed
+ * 'S': people passing through the open door
+ * 'R': door reopened followed by the latency in ms
+ * 'J': door motor fault
+ * 'U': door status broadcast to every HMI panel, see DOOR_STATUS_xxx_INDEX
+ *******************************************/
+#define SET_PASSWORD_ID			'P'
+#define LOGIN_ID				'L'
+#define SYNC_NEW_PASSWORD_ID	'N'
+#define SYNC_IDLE_ID			'I'
+#define SYNC_DOOR_BUSY_ID		'B'
+#define SYNC_LOCKOUT_ID			'X'
+#define PANEL_BUSY_ID			'Y'
+#define DOOR_STATUS_ID			'U'
+/*
+ * Status a Control ECU returns in each heartbeat acknowledge, read by the
+ * HMI ECU for every door on the bus: the sync state id followed by the
+ * progress of the running door move in percent. The 'U' broadcast adds the
+ * link address of the panel holding the door session
+ */
+#define DOOR_STATUS_STATE_INDEX		0u
+#define DOOR_STATUS_PROGRESS_INDEX	1u
+#define DOOR_STATUS_PANEL_INDEX		2u
+#define DOOR_STATUS_SIZE			3u
+#define DOOR_STATUS_NO_PANEL		0xFFu
+
+/* Worst case door travel time, used until the travel time is learned */
+#define DOOR_DEFAULT_TRAVEL_TIME_MS				15000u
+/*
+ * Watchdog on a door move, a close may be reversed once and run up to
+ * twice the travel time
+ */
+#define DOOR_MOVE_TIMEOUT_MS					((2UL * DOOR_DEFAULT_TRAVEL_TIME_MS) + 2000UL)
 
 #endif /* DOOR_LOCK_STATES_H_ */
@@ -0,0 +1,248 @@
+/*
+ *  File: Source file for Door position feedback
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "door_position.h"
+#include "tick.h"
+#include "common_macros.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile DoorPosition_StateType g_door_state = DOOR_POSITION_CLOSED;
+/* direction of the running move, STOP when the door is not being moved */
+static volatile DcMotor_State g_door_direction = STOP;
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_LIMIT_SWITCHES)
+static uint8 g_door_closed_switch_ms = 0;
+static uint8 g_door_open_switch_ms = 0;
+#endif
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+static volatile sint16 g_door_count = 0;
+static volatile uint32 g_door_last_edge_us = 0;
+static volatile uint32 g_door_pulse_period_us = 0;
+/* last driven direction, a single channel sensor keeps counting it while the door coasts */
+static volatile DcMotor_State g_door_count_direction = STOP;
+#endif
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Switch to the given end state and stop the motor without a ramp
+ */
+static void DoorPosition_arrive(DoorPosition_StateType state)
+{
+	DcMotor_haltProfile();
+	g_door_state = state;
+	g_door_direction = STOP;
+}
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_LIMIT_SWITCHES)
+/*
+ * Counts how long a switch has been active, saturating at the debounce time
+ */
+static uint8 DoorPosition_debounceSwitch(uint8 port_id, uint8 pin_id, uint8 active_ms)
+{
+	uint8 pin_value;
+	GPIO_readPin(port_id, pin_id, &pin_value);
+	if(pin_value != DOOR_LIMIT_ACTIVE_LEVEL)
+	{
+		return 0;
+	}
+	return (active_ms < DOOR_LIMIT_DEBOUNCE_MS) ? (active_ms + 1) : active_ms;
+}
+#endif
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+/*
+ * Encoder edge, ICR1 holds the Timer1 count at the edge so the
+ * timestamp is the tick count plus the position inside the tick
+ */
+ISR(TIMER1_CAPT_vect)
+{
+	uint16 capture = ICR1;
+	Tick_Type ticks = Tick_getTicks();
+	uint32 edge_us;
+	uint8 channel_b_value;
+
+	/* the compare match that ends this tick may be pending behind this interrupt */
+	if(BIT_IS_SET(TIFR, OCF1A) && (capture < (TICK_COMPARE_VALUE / 2)))
+	{
+		ticks++;
+	}
+	edge_us = (ticks * 1000UL * TICK_PERIOD_MS) + ((uint32)capture * TICK_US_PER_TIMER_COUNT);
+	g_door_pulse_period_us = edge_us - g_door_last_edge_us;
+	g_door_last_edge_us = edge_us;
+
+#if (DOOR_ENCODER_QUADRATURE == TRUE)
+	GPIO_readPin(DOOR_ENCODER_B_PORT_ID, DOOR_ENCODER_B_PIN_ID, &channel_b_value);
+	if(channel_b_value == DOOR_ENCODER_B_OPEN_LEVEL)
+#else
+	(void)channel_b_value;
+	if(g_door_count_direction == DOOR_POSITION_OPEN_DIRECTION)
+#endif
+	{
+		g_door_count++;
+	}
+	else
+	{
+		g_door_count--;
+	}
+}
+#endif
+
+/*
+ * Runs every tick, checks for arrival and overtravel
+ */
+static void DoorPosition_tickHook(void)
+{
+	DoorPosition_StateType target_state;
+	boolean is_arrived = FALSE;
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+	sint16 count = g_door_count;
+	sint16 remaining_counts;
+
+	if((count > (DOOR_ENCODER_OPEN_COUNT + DOOR_ENCODER_OVERTRAVEL_COUNTS)) || (count < -DOOR_ENCODER_OVERTRAVEL_COUNTS))
+	{
+		if(g_door_state != DOOR_POSITION_OVERTRAVEL)
+		{
+			DoorPosition_arrive(DOOR_POSITION_OVERTRAVEL);
+		}
+		return;
+	}
+#elif (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_LIMIT_SWITCHES)
+	g_door_closed_switch_ms = DoorPosition_debounceSwitch(DOOR_LIMIT_CLOSED_PORT_ID, DOOR_LIMIT_CLOSED_PIN_ID, g_door_closed_switch_ms);
+	g_door_open_switch_ms = DoorPosition_debounceSwitch(DOOR_LIMIT_OPEN_PORT_ID, DOOR_LIMIT_OPEN_PIN_ID, g_door_open_switch_ms);
+	if((g_door_closed_switch_ms == DOOR_LIMIT_DEBOUNCE_MS) && (g_door_open_switch_ms == DOOR_LIMIT_DEBOUNCE_MS))
+	{
+		if(g_door_state != DOOR_POSITION_FAULT)
+		{
+			DoorPosition_arrive(DOOR_POSITION_FAULT);
+		}
+		return;
+	}
+#endif
+
+	if(g_door_direction == STOP)
+	{
+		return;
+	}
+	target_state = (g_door_direction == DOOR_POSITION_OPEN_DIRECTION) ? DOOR_POSITION_OPEN : DOOR_POSITION_CLOSED;
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+	remaining_counts = (target_state == DOOR_POSITION_OPEN) ? (DOOR_ENCODER_OPEN_COUNT - count) : count;
+	if(remaining_counts <= 0)
+	{
+		is_arrived = TRUE;
+	}
+	else if(remaining_counts <= DOOR_ENCODER_SLOWDOWN_COUNTS)
+	{
+		DcMotor_stopProfile(); /* no effect once decelerating */
+	}
+#elif (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_LIMIT_SWITCHES)
+	if(target_state == DOOR_POSITION_OPEN)
+	{
+		is_arrived = (g_door_open_switch_ms == DOOR_LIMIT_DEBOUNCE_MS);
+	}
+	else
+	{
+		is_arrived = (g_door_closed_switch_ms == DOOR_LIMIT_DEBOUNCE_MS);
+	}
+#else
+	is_arrived = !DcMotor_isMoving();
+#endif
+
+	if(is_arrived == TRUE)
+	{
+		DoorPosition_arrive(target_state);
+	}
+	else if(DcMotor_isMoving() == FALSE)
+	{
+		/* the profile ran out before the end position was reached */
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_LIMIT_SWITCHES)
+		g_door_state = DOOR_POSITION_FAULT;
+#else
+		g_door_state = DOOR_POSITION_BETWEEN;
+#endif
+		g_door_direction = STOP;
+	}
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void DoorPosition_init(void)
+{
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_LIMIT_SWITCHES)
+	GPIO_setupPinDirection(DOOR_LIMIT_CLOSED_PORT_ID, DOOR_LIMIT_CLOSED_PIN_ID, PIN_INPUT);
+	GPIO_setupPinDirection(DOOR_LIMIT_OPEN_PORT_ID, DOOR_LIMIT_OPEN_PIN_ID, PIN_INPUT);
+	/* internal pull-ups */
+	GPIO_writePin(DOOR_LIMIT_CLOSED_PORT_ID, DOOR_LIMIT_CLOSED_PIN_ID, LOGIC_HIGH);
+	GPIO_writePin(DOOR_LIMIT_OPEN_PORT_ID, DOOR_LIMIT_OPEN_PIN_ID, LOGIC_HIGH);
+#elif (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+	GPIO_setupPinDirection(PORTD_ID, PIN6_ID, PIN_INPUT); /* ICP1 */
+	GPIO_setupPinDirection(DOOR_ENCODER_B_PORT_ID, DOOR_ENCODER_B_PIN_ID, PIN_INPUT);
+	/*
+	 * Timer1 is already running as the tick, only the capture unit is added:
+	 * noise canceler on, rising edge
+	 */
+	TCCR1B |= (1<<ICNC1) | (1<<ICES1);
+	TIFR = (1<<ICF1); /* clear a stale capture flag, writing one clears it */
+	SET_BIT(TIMSK, TICIE1);
+#endif
+	Tick_addHook(DoorPosition_tickHook);
+}
+
+void DoorPosition_move(DcMotor_State direction, const DcMotor_ProfileType* profile_Ptr)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	g_door_direction = direction;
+	if(direction != STOP)
+	{
+		g_door_state = DOOR_POSITION_BETWEEN;
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+		g_door_count_direction = direction;
+#endif
+	}
+	DcMotor_moveProfile(direction, profile_Ptr);
+	SREG = sreg_value;
+}
+
+DoorPosition_StateType DoorPosition_getState(void)
+{
+	return g_door_state;
+}
+
+sint16 DoorPosition_getCount(void)
+{
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+	sint16 count;
+	uint8 sreg_value = SREG;
+	cli();
+	count = g_door_count;
+	SREG = sreg_value;
+	return count;
+#else
+	/* without an encoder only the end positions are known */
+	return (g_door_state == DOOR_POSITION_OPEN) ? DOOR_ENCODER_OPEN_COUNT : 0;
+#endif
+}
+
+uint32 DoorPosition_getPulsePeriodUs(void)
+{
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+	uint32 period_us;
+	uint8 sreg_value = SREG;
+	cli();
+	period_us = g_door_pulse_period_us;
+	SREG = sreg_value;
+	return period_us;
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,119 @@
+/*
+ *  File: Header file for Door position feedback
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef DOOR_POSITION_H_
+#define DOOR_POSITION_H_
+
+#include "std_types.h"
+#include "gpio.h"
+#include "dcmotor.h"
+#include "dcmotor_profile.h"
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+typedef enum{
+	DOOR_POSITION_CLOSED,
+	DOOR_POSITION_OPEN,
+	DOOR_POSITION_BETWEEN,
+	DOOR_POSITION_OVERTRAVEL,		/* encoder passed an end position by more than the margin */
+	DOOR_POSITION_FAULT				/* end switch not reached in time or both switches active */
+}DoorPosition_StateType;
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/*
+ * Feedback modes:
+ * timed: the door is at its end once the motion profile finishes (no sensors)
+ * limit switches: end-stop switches stop the motor on arrival
+ * encoder: pulses on ICP1 are counted and timestamped by Timer1 input capture
+ */
+#define DOOR_POSITION_TIMED						0u
+#define DOOR_POSITION_LIMIT_SWITCHES			1u
+#define DOOR_POSITION_ENCODER					2u
+
+#define DOOR_POSITION_MODE_SELECT				DOOR_POSITION_TIMED
+
+/* Motor state that opens the door */
+#define DOOR_POSITION_OPEN_DIRECTION			CW
+
+/*
+ * End-stop switches, active low with the internal pull-ups enabled
+ */
+#define DOOR_LIMIT_CLOSED_PORT_ID				PORTC_ID
+#define DOOR_LIMIT_CLOSED_PIN_ID				PIN3_ID
+#define DOOR_LIMIT_OPEN_PORT_ID					PORTC_ID
+#define DOOR_LIMIT_OPEN_PIN_ID					PIN4_ID
+#define DOOR_LIMIT_ACTIVE_LEVEL					LOGIC_LOW
+#define DOOR_LIMIT_DEBOUNCE_MS					5u
+
+/*
+ * Encoder, channel A is ICP1 (PD6) so the motor can not be wired to PD6 in
+ * this mode. For a quadrature encoder the level of channel B on the edge
+ * of channel A gives the direction, a single channel hall sensor uses the
+ * direction the motor is driven in
+ */
+#define DOOR_ENCODER_QUADRATURE					TRUE
+#define DOOR_ENCODER_B_PORT_ID					PORTD_ID
+#define DOOR_ENCODER_B_PIN_ID					PIN4_ID
+#define DOOR_ENCODER_B_OPEN_LEVEL				LOGIC_HIGH
+
+/* Encoder counts between the closed and open positions */
+#define DOOR_ENCODER_OPEN_COUNT					1200
+/* The deceleration ramp starts this many counts before the target */
+#define DOOR_ENCODER_SLOWDOWN_COUNTS			150
+/* Counts past an end position that are reported as overtravel */
+#define DOOR_ENCODER_OVERTRAVEL_COUNTS			40
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER) && (DC_MOTOR_PORT_ID == PORTD_ID) && \
+	((DC_MOTOR_INT1_PIN_ID == PIN6_ID) || (DC_MOTOR_INT2_PIN_ID == PIN6_ID))
+#error "Encoder mode uses ICP1 (PD6), move the DC motor pins"
+#endif
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER) && (PWM_TIMER_SELECT == PWM_TIMER1)
+#error "Encoder timestamps need Timer1 running as the system tick, drive the motor from Timer0"
+#endif
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Sets up the feedback inputs and attaches to the system tick,
+ * the door is assumed closed at power up
+ */
+void DoorPosition_init(void);
+
+/*
+ * Description:
+ * Moves the door with the given profile and returns immediately,
+ * the motor is stopped as soon as the end position is reached.
+ * The profile length is the timeout of the move
+ */
+void DoorPosition_move(DcMotor_State direction, const DcMotor_ProfileType* profile_Ptr);
+
+/*
+ * Description:
+ * Returns the last known door position
+ */
+DoorPosition_StateType DoorPosition_getState(void);
+
+/*
+ * Description:
+ * Returns the encoder count, 0 is closed and DOOR_ENCODER_OPEN_COUNT is open
+ */
+sint16 DoorPosition_getCount(void);
+
+/*
+ * Description:
+ * Returns the time between the last two encoder edges in microseconds
+ */
+uint32 DoorPosition_getPulsePeriodUs(void);
+
+#endif /* DOOR_POSITION_H_ */
@@ -0,0 +1,287 @@
+/*
+ *  File: Source file for Door travel time calibration
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "door_travel.h"
+#include "door_position.h"
+#include "dcmotor_profile.h"
+#include "external_eeprom.h"
+#include "door_lock_states.h"
+#include "tick.h"
+
+/* index of each direction in the tables below */
+#define DOOR_TRAVEL_OPEN_INDEX				0u
+#define DOOR_TRAVEL_CLOSE_INDEX				1u
+#define DOOR_TRAVEL_NUM_OF_DIRECTIONS		2u
+
+static uint16 g_door_travel_time_ms[DOOR_TRAVEL_NUM_OF_DIRECTIONS] = {DOOR_DEFAULT_TRAVEL_TIME_MS, DOOR_DEFAULT_TRAVEL_TIME_MS};
+static boolean g_door_travel_is_learning[DOOR_TRAVEL_NUM_OF_DIRECTIONS] = {TRUE, TRUE};
+static uint8 g_door_travel_moves = 0;
+static uint8 g_door_travel_direction_index = DOOR_TRAVEL_OPEN_INDEX;
+static volatile Tick_Type g_door_travel_start_tick = 0;
+/* profile time of the running move */
+static volatile uint16 g_door_travel_move_time_ms = DOOR_DEFAULT_TRAVEL_TIME_MS;
+/* the running move is a reopen that does not cover the whole travel */
+static volatile boolean g_door_travel_is_partial = FALSE;
+/* record being saved, the index of the next byte to write or the record size once done */
+static uint8 g_door_travel_record[DOOR_TRAVEL_EEPROM_RECORD_SIZE];
+static uint8 g_door_travel_save_index = DOOR_TRAVEL_EEPROM_RECORD_SIZE;
+static uint8 g_door_travel_save_retries = 0;
+static Tick_Type g_door_travel_save_tick = 0;
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Fills a profile that takes travel_time_ms, keeping the default ramps
+ * unless the move is too short for them
+ */
+static void DoorTravel_buildProfile(uint16 travel_time_ms, DcMotor_ProfileType* profile_Ptr)
+{
+	profile_Ptr->cruise_duty = DC_MOTOR_DEFAULT_CRUISE_DUTY;
+	profile_Ptr->ramp_shape = DC_MOTOR_RAMP_S_CURVE;
+	if(travel_time_ms > (DC_MOTOR_DEFAULT_ACCEL_TIME_MS + DC_MOTOR_DEFAULT_DECEL_TIME_MS))
+	{
+		profile_Ptr->accel_time_ms = DC_MOTOR_DEFAULT_ACCEL_TIME_MS;
+		profile_Ptr->decel_time_ms = DC_MOTOR_DEFAULT_DECEL_TIME_MS;
+		profile_Ptr->cruise_time_ms = travel_time_ms - DC_MOTOR_DEFAULT_ACCEL_TIME_MS - DC_MOTOR_DEFAULT_DECEL_TIME_MS;
+	}
+	else
+	{
+		profile_Ptr->accel_time_ms = travel_time_ms / 2;
+		profile_Ptr->decel_time_ms = travel_time_ms - profile_Ptr->accel_time_ms;
+		profile_Ptr->cruise_time_ms = 0;
+	}
+}
+
+static uint8 DoorTravel_checksum(const uint8* record_Ptr)
+{
+	uint8 index, checksum = 0;
+	for(index = 0; index < (DOOR_TRAVEL_EEPROM_RECORD_SIZE - 1); index++)
+	{
+		checksum += record_Ptr[index];
+	}
+	return (uint8)(~checksum);
+}
+
+/*
+ * Record layout: magic, open time (2 bytes), close time (2 bytes), checksum.
+ * The bytes are written by DoorTravel_service(), a newer record restarts the save
+ */
+static void DoorTravel_save(void)
+{
+	g_door_travel_record[0] = DOOR_TRAVEL_EEPROM_MAGIC;
+	g_door_travel_record[1] = (uint8)(g_door_travel_time_ms[DOOR_TRAVEL_OPEN_INDEX] >> 8);
+	g_door_travel_record[2] = (uint8)(g_door_travel_time_ms[DOOR_TRAVEL_OPEN_INDEX]);
+	g_door_travel_record[3] = (uint8)(g_door_travel_time_ms[DOOR_TRAVEL_CLOSE_INDEX] >> 8);
+	g_door_travel_record[4] = (uint8)(g_door_travel_time_ms[DOOR_TRAVEL_CLOSE_INDEX]);
+	g_door_travel_record[5] = DoorTravel_checksum(g_door_travel_record);
+	g_door_travel_save_index = 0;
+	g_door_travel_save_retries = DOOR_TRAVEL_EEPROM_MAX_RETRIES;
+	/* a byte of the previous save may still be in its write cycle */
+	g_door_travel_save_tick = Tick_getTicks();
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void DoorTravel_init(void)
+{
+	uint8 record[DOOR_TRAVEL_EEPROM_RECORD_SIZE];
+	uint16 open_time_ms, close_time_ms;
+
+	if(EEPROM_readByteStream(DOOR_TRAVEL_EEPROM_ADDRESS, record, DOOR_TRAVEL_EEPROM_RECORD_SIZE) != DOOR_TRAVEL_EEPROM_RECORD_SIZE)
+	{
+		return;
+	}
+	if((record[0] != DOOR_TRAVEL_EEPROM_MAGIC) || (record[5] != DoorTravel_checksum(record)))
+	{
+		return;
+	}
+	open_time_ms = ((uint16)record[1] << 8) | record[2];
+	close_time_ms = ((uint16)record[3] << 8) | record[4];
+	if((open_time_ms < DOOR_TRAVEL_MIN_TIME_MS) || (open_time_ms > DOOR_DEFAULT_TRAVEL_TIME_MS)
+			|| (close_time_ms < DOOR_TRAVEL_MIN_TIME_MS) || (close_time_ms > DOOR_DEFAULT_TRAVEL_TIME_MS))
+	{
+		return;
+	}
+	g_door_travel_time_ms[DOOR_TRAVEL_OPEN_INDEX] = open_time_ms;
+	g_door_travel_time_ms[DOOR_TRAVEL_CLOSE_INDEX] = close_time_ms;
+	g_door_travel_is_learning[DOOR_TRAVEL_OPEN_INDEX] = FALSE;
+	g_door_travel_is_learning[DOOR_TRAVEL_CLOSE_INDEX] = FALSE;
+}
+
+void DoorTravel_startMove(DcMotor_State direction)
+{
+	DcMotor_ProfileType profile;
+
+	g_door_travel_direction_index = (direction == DOOR_POSITION_OPEN_DIRECTION) ? DOOR_TRAVEL_OPEN_INDEX : DOOR_TRAVEL_CLOSE_INDEX;
+	if(g_door_travel_moves >= DOOR_TRAVEL_RELEARN_MOVES)
+	{
+		DoorTravel_requestCalibration();
+	}
+	g_door_travel_moves++;
+
+	/* a learning move runs for the worst case time and is ended by the feedback */
+	if(g_door_travel_is_learning[g_door_travel_direction_index] == TRUE)
+	{
+		g_door_travel_move_time_ms = DOOR_DEFAULT_TRAVEL_TIME_MS;
+	}
+	else
+	{
+		g_door_travel_move_time_ms = g_door_travel_time_ms[g_door_travel_direction_index];
+	}
+	DoorTravel_buildProfile(g_door_travel_move_time_ms, &profile);
+	g_door_travel_is_partial = FALSE;
+	g_door_travel_start_tick = Tick_getTicks();
+	DoorPosition_move(direction, &profile);
+}
+
+void DoorTravel_startReopen(uint32 closing_time_ms)
+{
+	DcMotor_ProfileType profile;
+	uint32 reopen_time_ms = closing_time_ms + DOOR_TRAVEL_MARGIN_MS;
+
+	if(reopen_time_ms > DoorTravel_getTravelTime(DOOR_POSITION_OPEN_DIRECTION))
+	{
+		reopen_time_ms = DoorTravel_getTravelTime(DOOR_POSITION_OPEN_DIRECTION);
+	}
+	g_door_travel_move_time_ms = (uint16)reopen_time_ms;
+	DoorTravel_buildProfile(g_door_travel_move_time_ms, &profile);
+	g_door_travel_direction_index = DOOR_TRAVEL_OPEN_INDEX;
+	g_door_travel_is_partial = TRUE;
+	g_door_travel_start_tick = Tick_getTicks();
+	DoorPosition_move(DOOR_POSITION_OPEN_DIRECTION, &profile);
+}
+
+uint8 DoorTravel_getProgress(void)
+{
+	uint32 progress;
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_ENCODER)
+	sint16 count = DoorPosition_getCount();
+	if(count < 0)
+	{
+		count = 0;
+	}
+	progress = ((uint32)count * 100u) / DOOR_ENCODER_OPEN_COUNT;
+	if(progress > 100u)
+	{
+		progress = 100u;
+	}
+	if(g_door_travel_direction_index == DOOR_TRAVEL_CLOSE_INDEX)
+	{
+		progress = 100u - progress;
+	}
+#else
+	progress = (Tick_elapsedSince(g_door_travel_start_tick) * 100u) / g_door_travel_move_time_ms;
+#endif
+	if(progress > DOOR_TRAVEL_MAX_PROGRESS_PERCENT)
+	{
+		progress = DOOR_TRAVEL_MAX_PROGRESS_PERCENT;
+	}
+	return (uint8)progress;
+}
+
+boolean DoorTravel_isNearEnd(void)
+{
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_TIMED)
+	uint8 index = g_door_travel_direction_index;
+	return ((g_door_travel_is_learning[index] == TRUE) || (g_door_travel_is_partial == TRUE) ||
+			(Tick_elapsedSince(g_door_travel_start_tick) >= ((uint32)g_door_travel_time_ms[index] * (100u - DOOR_TRAVEL_END_STALL_PERCENT) / 100u)));
+#else
+	/* the end positions are sensed so a stall is never the end of travel */
+	return FALSE;
+#endif
+}
+
+boolean DoorTravel_isMoving(void)
+{
+	return DcMotor_isMoving();
+}
+
+boolean DoorTravel_finishMove(void)
+{
+	uint8 index = g_door_travel_direction_index;
+	uint32 measured_ms = Tick_elapsedSince(g_door_travel_start_tick);
+	boolean is_measured;
+
+#if (DOOR_POSITION_MODE_SELECT == DOOR_POSITION_TIMED)
+	/*
+	 * No sensors, the stall current when the door hits its end stop marks
+	 * the end of travel. A learned move expects it near its end only
+	 */
+	is_measured = FALSE;
+	if((DcMotor_getFault() == DC_MOTOR_STALL) && (DoorTravel_isNearEnd() == TRUE))
+	{
+		DcMotor_clearFault();
+		is_measured = TRUE;
+	}
+#else
+	is_measured = (DoorPosition_getState() == ((index == DOOR_TRAVEL_OPEN_INDEX) ? DOOR_POSITION_OPEN : DOOR_POSITION_CLOSED));
+#endif
+
+	if(DcMotor_getFault() != DC_MOTOR_NO_FAULT)
+	{
+		return FALSE;
+	}
+
+	if((g_door_travel_is_learning[index] == TRUE) && (g_door_travel_is_partial == FALSE)
+			&& (is_measured == TRUE) && (measured_ms >= DOOR_TRAVEL_MIN_TIME_MS))
+	{
+		measured_ms += DOOR_TRAVEL_MARGIN_MS + ((measured_ms * DOOR_TRAVEL_MARGIN_PERCENT) / 100u);
+		if(measured_ms > DOOR_DEFAULT_TRAVEL_TIME_MS)
+		{
+			measured_ms = DOOR_DEFAULT_TRAVEL_TIME_MS;
+		}
+		g_door_travel_time_ms[index] = (uint16)measured_ms;
+		g_door_travel_is_learning[index] = FALSE;
+		/* the record is written once both directions are known */
+		if((g_door_travel_is_learning[DOOR_TRAVEL_OPEN_INDEX] == FALSE) && (g_door_travel_is_learning[DOOR_TRAVEL_CLOSE_INDEX] == FALSE))
+		{
+			DoorTravel_save();
+		}
+	}
+	return TRUE;
+}
+
+void DoorTravel_service(void)
+{
+	if((g_door_travel_save_index >= DOOR_TRAVEL_EEPROM_RECORD_SIZE) ||
+			(Tick_elapsedSince(g_door_travel_save_tick) < DOOR_TRAVEL_EEPROM_WRITE_TIME_MS))
+	{
+		return;
+	}
+	g_door_travel_save_tick = Tick_getTicks();
+	/* the byte stream writer stops at zero bytes so the record is written byte by byte */
+	if(EEPROM_writeByte((uint16)(DOOR_TRAVEL_EEPROM_ADDRESS + g_door_travel_save_index),
+			g_door_travel_record[g_door_travel_save_index]) == SUCCESS)
+	{
+		g_door_travel_save_index++;
+		g_door_travel_save_retries = DOOR_TRAVEL_EEPROM_MAX_RETRIES;
+	}
+	else if(g_door_travel_save_retries > 0)
+	{
+		g_door_travel_save_retries--;
+	}
+	else
+	{
+		/* given up, the checksum rejects the half written record on the next boot */
+		g_door_travel_save_index = DOOR_TRAVEL_EEPROM_RECORD_SIZE;
+	}
+}
+
+uint16 DoorTravel_getTravelTime(DcMotor_State direction)
+{
+	uint8 index = (direction == DOOR_POSITION_OPEN_DIRECTION) ? DOOR_TRAVEL_OPEN_INDEX : DOOR_TRAVEL_CLOSE_INDEX;
+	return g_door_travel_is_learning[index] ? DOOR_DEFAULT_TRAVEL_TIME_MS : g_door_travel_time_ms[index];
+}
+
+void DoorTravel_requestCalibration(void)
+{
+	g_door_travel_moves = 0;
+	g_door_travel_is_learning[DOOR_TRAVEL_OPEN_INDEX] = TRUE;
+	g_door_travel_is_learning[DOOR_TRAVEL_CLOSE_INDEX] = TRUE;
+}
@@ -0,0 +1,115 @@
+/*
+ *  File: Header file for Door travel time calibration
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef DOOR_TRAVEL_H_
+#define DOOR_TRAVEL_H_
+
+#include "std_types.h"
+#include "dcmotor.h"
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/*
+ * Learned open and close times are kept in the external EEPROM,
+ * away from the password stored at 0x0200
+ */
+#define DOOR_TRAVEL_EEPROM_ADDRESS				0x0300u
+#define DOOR_TRAVEL_EEPROM_MAGIC				0xA5u
+#define DOOR_TRAVEL_EEPROM_RECORD_SIZE			6u
+/* write cycle time of the EEPROM after each byte */
+#define DOOR_TRAVEL_EEPROM_WRITE_TIME_MS		10u
+/* a byte the EEPROM did not take is written again up to this many times */
+#define DOOR_TRAVEL_EEPROM_MAX_RETRIES			3u
+
+/* Margin added to a measured travel time: a fixed part and a percentage */
+#define DOOR_TRAVEL_MARGIN_MS					300u
+#define DOOR_TRAVEL_MARGIN_PERCENT				10u
+/* Measurements shorter than this are treated as a bad learning cycle */
+#define DOOR_TRAVEL_MIN_TIME_MS					1000u
+/* Both directions are learned again after this many moves */
+#define DOOR_TRAVEL_RELEARN_MOVES				50u
+/*
+ * Without position sensors the end stop is found from the stall current,
+ * a stall in the last part of a learned move is the door hitting its end
+ */
+#define DOOR_TRAVEL_END_STALL_PERCENT			20u
+/* a running move never reports more than this, its end is reported by the caller */
+#define DOOR_TRAVEL_MAX_PROGRESS_PERCENT		99u
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Loads the learned travel times from the EEPROM, TWI must be initialized.
+ * Without a valid record the next open and close moves are learning moves
+ */
+void DoorTravel_init(void);
+
+/*
+ * Description:
+ * Starts a door move using the learned travel time of the direction,
+ * or the worst case time while that direction is being learned
+ */
+void DoorTravel_startMove(DcMotor_State direction);
+
+/*
+ * Description:
+ * Returns TRUE while the door move is running
+ */
+boolean DoorTravel_isMoving(void);
+
+/*
+ * Description:
+ * Must be called once the move has ended, measures the move while learning
+ * and queues new values for the EEPROM. Returns FALSE if the motor faulted
+ */
+boolean DoorTravel_finishMove(void);
+
+/*
+ * Description:
+ * Writes the queued record to the EEPROM one byte per write cycle, called
+ * continuously from the main loop so a save never blocks it
+ */
+void DoorTravel_service(void);
+
+/*
+ * Description:
+ * Returns how far the running move is in percent, from the encoder count
+ * when it is fitted, otherwise from the time spent against the move time
+ */
+uint8 DoorTravel_getProgress(void);
+
+/*
+ * Description:
+ * Returns TRUE when a stall in the running move would be the door reaching
+ * its end stop rather than an obstruction (only without position sensors)
+ */
+boolean DoorTravel_isNearEnd(void);
+
+/*
+ * Description:
+ * Opens the door again after it closed for closing_time_ms, this partial
+ * move is not used for learning. Safe to call from interrupt context
+ */
+void DoorTravel_startReopen(uint32 closing_time_ms);
+
+/*
+ * Description:
+ * Returns the time in milliseconds a move in the given direction takes
+ */
+uint16 DoorTravel_getTravelTime(DcMotor_State direction);
+
+/*
+ * Description:
+ * Makes the next open and close moves learning moves
+ */
+void DoorTravel_requestCalibration(void);
+
+#endif /* DOOR_TRAVEL_H_ */
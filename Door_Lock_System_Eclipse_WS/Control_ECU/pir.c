@@ -4,18 +4,127 @@
  *
  * File Name: pir.c
  *
- * Description: Source file for the TWI(I2C) AVR driver
+ * Description: Source file for the PIR occupancy tracker
  *
  * Author: Seifalla Ehab Mohamed
  *
  *******************************************************************************/
 #include "pir.h"
 #include "gpio.h"
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
 
+typedef enum
+{
+	PIR_VACANT,
+	PIR_OCCUPIED,
+	PIR_STUCK			/* timed out, waiting for the sensor to go low */
+}PIR_TrackerStateType;
+
+static PIR_ConfigType g_pir_config = {PIR_DEFAULT_TRIGGER_DEBOUNCE_MS, PIR_DEFAULT_HOLD_TIME_MS, PIR_DEFAULT_MAX_OCCUPANCY_MS};
+static volatile PIR_TrackerStateType g_pir_state = PIR_VACANT;
+static uint8 g_pir_sample_ticks = 0;
+static uint16 g_pir_high_time_ms = 0;
+static uint16 g_pir_low_time_ms = 0;
+static uint32 g_pir_occupied_time_ms = 0;
+
+static volatile PIR_EventType g_pir_event_queue[PIR_EVENT_QUEUE_SIZE];
+static volatile uint8 g_pir_queue_head = 0;
+static volatile uint8 g_pir_queue_tail = 0;
+
+/*
+ * Description:
+ * Adds an event to the queue, called from the tick
+ */
+static void PIR_postEvent(PIR_EventKindType kind, uint32 occupied_time_ms)
+{
+	uint8 head = g_pir_queue_head;
+	uint8 next_head = (uint8)((head + 1) % PIR_EVENT_QUEUE_SIZE);
+	if(next_head == g_pir_queue_tail)
+	{
+		return; /* queue is full, the application is not reading so drop the event */
+	}
+	g_pir_event_queue[head].kind = kind;
+	g_pir_event_queue[head].occupied_time_ms = occupied_time_ms;
+	g_pir_queue_head = next_head;
+}
 
-void PIR_init(void)
+/*
+ * Description:
+ * Samples the sensor and runs the occupancy state machine
+ */
+static void PIR_tickHook(void)
+{
+	uint8 pir_value;
+
+	g_pir_sample_ticks++;
+	if(g_pir_sample_ticks < (PIR_SAMPLE_PERIOD_MS / TICK_PERIOD_MS))
+	{
+		return;
+	}
+	g_pir_sample_ticks = 0;
+
+	GPIO_readPin(PIR_PORT_ID, PIR_PIN_ID, &pir_value);
+	if(pir_value == LOGIC_HIGH)
+	{
+		g_pir_low_time_ms = 0;
+		if(g_pir_high_time_ms < g_pir_config.trigger_debounce_ms)
+		{
+			g_pir_high_time_ms += PIR_SAMPLE_PERIOD_MS;
+		}
+	}
+	else
+	{
+		g_pir_high_time_ms = 0;
+		if(g_pir_low_time_ms < g_pir_config.hold_time_ms)
+		{
+			g_pir_low_time_ms += PIR_SAMPLE_PERIOD_MS;
+		}
+	}
+
+	switch(g_pir_state)
+	{
+	case PIR_VACANT:
+		if(g_pir_high_time_ms >= g_pir_config.trigger_debounce_ms)
+		{
+			g_pir_state = PIR_OCCUPIED;
+			g_pir_occupied_time_ms = 0;
+			PIR_postEvent(PIR_EVENT_OCCUPIED, 0);
+		}
+		break;
+	case PIR_OCCUPIED:
+		g_pir_occupied_time_ms += PIR_SAMPLE_PERIOD_MS;
+		/* every high sample retriggers the hold time */
+		if(g_pir_low_time_ms >= g_pir_config.hold_time_ms)
+		{
+			g_pir_state = PIR_VACANT;
+			PIR_postEvent(PIR_EVENT_VACANT, g_pir_occupied_time_ms);
+		}
+		else if(g_pir_occupied_time_ms >= g_pir_config.max_occupancy_ms)
+		{
+			g_pir_state = PIR_STUCK;
+			PIR_postEvent(PIR_EVENT_TIMEOUT, g_pir_occupied_time_ms);
+		}
+		break;
+	case PIR_STUCK:
+		/* the sensor is trusted again once it has been low for the hold time */
+		if(g_pir_low_time_ms >= g_pir_config.hold_time_ms)
+		{
+			g_pir_state = PIR_VACANT;
+		}
+		break;
+	}
+}
+
+void PIR_init(const PIR_ConfigType* Config_Ptr)
 {
 	GPIO_setupPinDirection(PIR_PORT_ID, PIR_PIN_ID, PIN_INPUT);
+	if(Config_Ptr != NULL_PTR)
+	{
+		g_pir_config = *Config_Ptr;
+	}
+	Tick_addHook(PIR_tickHook);
 }
 
 uint8 PIR_getState(void)
@@ -25,3 +134,31 @@ uint8 PIR_getState(void)
 
 	return pir_state_value;
 }
+
+boolean PIR_isOccupied(void)
+{
+	return (g_pir_state == PIR_OCCUPIED);
+}
+
+boolean PIR_getEvent(PIR_EventType* event_Ptr)
+{
+	uint8 tail = g_pir_queue_tail;
+	uint8 sreg_value;
+	if(tail == g_pir_queue_head)
+	{
+		return FALSE;
+	}
+	/* the 32-bit time is written by the tick so it is copied atomically */
+	sreg_value = SREG;
+	cli();
+	event_Ptr->kind = g_pir_event_queue[tail].kind;
+	event_Ptr->occupied_time_ms = g_pir_event_queue[tail].occupied_time_ms;
+	SREG = sreg_value;
+	g_pir_queue_tail = (uint8)((tail + 1) % PIR_EVENT_QUEUE_SIZE);
+	return TRUE;
+}
+
+void PIR_flushEvents(void)
+{
+	g_pir_queue_tail = g_pir_queue_head;
+}
@@ -4,7 +4,7 @@
  *
  * File Name: pir.h
  *
- * Description: Header file for the TWI(I2C) AVR driver
+ * Description: Header file for the PIR occupancy tracker
  *
  * Author: Seifalla Ehab Mohamed
  *
@@ -15,18 +15,79 @@
 
 #include "std_types.h"
 
+/***********************************************
+ * 					Types
+ ***********************************************/
+typedef enum
+{
+	PIR_EVENT_OCCUPIED,		/* motion seen while the area was vacant */
+	PIR_EVENT_VACANT,		/* no motion for the hold time */
+	PIR_EVENT_TIMEOUT		/* motion never stopped for the maximum occupancy time, sensor ignored until it goes low */
+}PIR_EventKindType;
+
+typedef struct
+{
+	PIR_EventKindType kind;
+	uint32 occupied_time_ms;	/* time since the area became occupied, zero for occupied events */
+}PIR_EventType;
+
+typedef struct
+{
+	uint16 trigger_debounce_ms;	/* motion must last this long to count, filters glitches high */
+	uint16 hold_time_ms;		/* the area stays occupied this long after the last motion, filters glitches low */
+	uint32 max_occupancy_ms;	/* a sensor high for longer than this is treated as stuck */
+}PIR_ConfigType;
+
 /***********************************************
  * 				Definitions
  ***********************************************/
 #define PIR_PORT_ID				PORTC_ID
 #define PIR_PIN_ID				PIN2_ID
 
+/*
+ * PC2 has no external interrupt so the sensor is sampled from the system tick
+ */
+#define PIR_SAMPLE_PERIOD_MS				10u
+
+#define PIR_DEFAULT_TRIGGER_DEBOUNCE_MS		30u
+#define PIR_DEFAULT_HOLD_TIME_MS			2000u
+#define PIR_DEFAULT_MAX_OCCUPANCY_MS		60000UL
+
+#define PIR_EVENT_QUEUE_SIZE				4u
+
 /***********************************************
  * 			Function Prototypes
  ***********************************************/
+/*
+ * Description:
+ * Sets up the sensor pin and attaches the tracker to the system tick,
+ * passing NULL_PTR uses the default times
+ */
+void PIR_init(const PIR_ConfigType* Config_Ptr);
 
-void PIR_init(void);
+/*
+ * Description:
+ * Returns the raw sensor output
+ */
 uint8 PIR_getState(void);
 
+/*
+ * Description:
+ * Returns TRUE while the tracked area is occupied
+ */
+boolean PIR_isOccupied(void);
+
+/*
+ * Description:
+ * Gets the next occupancy event without waiting, returns FALSE if no event is queued
+ */
+boolean PIR_getEvent(PIR_EventType* event_Ptr);
+
+/*
+ * Description:
+ * Drops all the queued events
+ */
+void PIR_flushEvents(void);
+
 
 #endif /* PIR_H_ */
@@ -3,6 +3,10 @@
 #include "common_macros.h"
 #include "avr/io.h"
 
+#if (PWM_CARRIER_ACTUAL_HZ < PWM_CARRIER_FREQUENCY_HZ)
+#warning "PWM carrier is below PWM_CARRIER_FREQUENCY_HZ even without prescaling"
+#endif
+
 static void PWM_Timer0_Setup(void)
 {
 	/*
@@ -13,7 +17,11 @@ static void PWM_Timer0_Setup(void)
      * Selecting generation type
      */
     TIMER0_TCCR_REG.timer0_tccr.WGM00_bit = LOGIC_HIGH;
+#if (PWM_MODE_SELECT == PWM_MODE_PHASE_CORRECT)
+    TIMER0_TCCR_REG.timer0_tccr.WGM01_bit = LOGIC_LOW;
+#else
     TIMER0_TCCR_REG.timer0_tccr.WGM01_bit = LOGIC_HIGH;
+#endif
     /*
      * Selecting the line that generates the input and its mode (inverting or non inverting)
      */
@@ -24,22 +32,107 @@ static void PWM_Timer0_Setup(void)
     TIMER0_TCCR_REG.timer0_tccr.Clk_select_bits = TIMER0_PRESCALE_SELECT;
 }
 
-void PWM_Timer0_Start(uint8 pwm_duty_cycle)
+void PWM_Timer0_Init(void)
 {
     /*
      * Selecting timer count start value
      */
     TCNT0 = TIMER0_START_COUNT_VALUE;
+    OCR0 = TIMER0_DUTYCYCLE_0;
     /*
-     * Selecting the duty cycle value
+     * Setting OCR to output mode, it is held low while the duty is 0%
      */
-    OCR0 = (uint8)((float32)pwm_duty_cycle*2.56 -1);
-    /*
-	 * Setting OCR to output mode
-	 */
-	GPIO_setupPinDirection(TIMER0_OCR0_PORT_ID, TIMER0_OCR0_PIN_ID, PIN_OUTPUT);
+    GPIO_writePin(TIMER0_OCR0_PORT_ID, TIMER0_OCR0_PIN_ID, LOGIC_LOW);
+    GPIO_setupPinDirection(TIMER0_OCR0_PORT_ID, TIMER0_OCR0_PIN_ID, PIN_OUTPUT);
     /*
      * intial values and data
      */
     PWM_Timer0_Setup();
+    TIMER0_TCCR_REG.timer0_tccr.COM_bits = TIMER0_OCR_DISCONNECTED;
+}
+
+void PWM_Timer0_SetDuty(uint8 pwm_duty_cycle)
+{
+    if(pwm_duty_cycle == 0)
+    {
+        /*
+         * Fast PWM still outputs a one count pulse when OCR0 is 0,
+         * the pin is disconnected from the timer to get a real 0%
+         */
+        TIMER0_TCCR_REG.timer0_tccr.COM_bits = TIMER0_OCR_DISCONNECTED;
+        return;
+    }
+    if(pwm_duty_cycle > TIMER0_MAX_DUTY_CYCLE)
+    {
+        pwm_duty_cycle = TIMER0_MAX_DUTY_CYCLE;
+    }
+    OCR0 = (uint8)(((uint16)pwm_duty_cycle * TIMER0_DUTY_SCALE_FACTOR) >> TIMER0_DUTY_SCALE_SHIFT);
+    TIMER0_TCCR_REG.timer0_tccr.COM_bits = TIMER0_FAST_PWM_OCR_NON_INVERTING;
+}
+
+void PWM_Timer1_Init(void)
+{
+    TCNT1 = 0;
+    OCR1A = 0;
+    OCR1B = 0;
+    GPIO_writePin(TIMER1_OCR1_PORT_ID, TIMER1_OCR1_PIN_ID, LOGIC_LOW);
+    GPIO_setupPinDirection(TIMER1_OCR1_PORT_ID, TIMER1_OCR1_PIN_ID, PIN_OUTPUT);
+    /*
+     * 10-bit PWM (mode 7 fast, mode 3 phase correct), outputs disconnected until a duty is set
+     */
+    TCCR1A = (1<<WGM11) | (1<<WGM10);
+#if (PWM_MODE_SELECT == PWM_MODE_PHASE_CORRECT)
+    TCCR1B = PWM_PRESCALE_SELECT;
+#else
+    TCCR1B = (1<<WGM12) | PWM_PRESCALE_SELECT;
+#endif
+}
+
+void PWM_Timer1_SetDuty(uint8 pwm_duty_cycle)
+{
+    uint16 compare_value;
+    if(pwm_duty_cycle > TIMER1_MAX_DUTY_CYCLE)
+    {
+        pwm_duty_cycle = TIMER1_MAX_DUTY_CYCLE;
+    }
+    compare_value = (uint16)(((uint16)pwm_duty_cycle * TIMER1_DUTY_SCALE_FACTOR) >> TIMER1_DUTY_SCALE_SHIFT);
+#if (PWM_TIMER1_CHANNEL_SELECT == PWM_TIMER1_CHANNEL_B)
+    OCR1B = compare_value;
+    if(pwm_duty_cycle == 0)
+    {
+        TCCR1A &= ~((1<<COM1B1) | (1<<COM1B0));
+    }
+    else
+    {
+        TCCR1A |= (TIMER1_PWM_OCR_NON_INVERTING << COM1B0);
+    }
+#else
+    OCR1A = compare_value;
+    if(pwm_duty_cycle == 0)
+    {
+        TCCR1A &= ~((1<<COM1A1) | (1<<COM1A0));
+    }
+    else
+    {
+        TCCR1A |= (TIMER1_PWM_OCR_NON_INVERTING << COM1A0);
+    }
+#endif
+}
+
+void PWM_init(void)
+{
+#if (PWM_TIMER_SELECT == PWM_TIMER1)
+    PWM_Timer1_Init();
+#else
+    PWM_Timer0_Init();
+#endif
+}
+
+void PWM_setDuty(uint8 pwm_duty_cycle)
+{
+#if (PWM_TIMER_SELECT == PWM_TIMER1)
+    PWM_Timer1_SetDuty(pwm_duty_cycle);
+#else
+    PWM_Timer0_SetDuty(pwm_duty_cycle);
+#endif
 }
@@ -10,6 +10,7 @@
 #define	PWM_H
 
 #include "std_types.h"
+#include "gpio.h"
 
 /*******************************************************
  *                        Types
@@ -30,11 +31,41 @@ typedef union{
 /*******************************************************
  *                     Definitions
  *******************************************************/
+/*
+ * Timer driving the motor, Timer1 gives 10-bit resolution and leaves
+ * Timer0 free (the system tick moves to Timer0 in that case)
+ */
+#define PWM_TIMER0                                                      0u
+#define PWM_TIMER1                                                      1u
+#define PWM_TIMER_SELECT                                                PWM_TIMER0
+
+/*
+ * Waveform, phase correct PWM halves the carrier but keeps the pulses
+ * centred which gives smoother torque at low duty
+ */
+#define PWM_MODE_FAST                                                   0u
+#define PWM_MODE_PHASE_CORRECT                                          1u
+#define PWM_MODE_SELECT                                                 PWM_MODE_FAST
+
+/*
+ * Lowest acceptable carrier, the slowest prescaler that still reaches it is
+ * chosen at compile time from F_CPU. 20 kHz keeps the motor whine inaudible
+ */
+#define PWM_CARRIER_FREQUENCY_HZ                                        20000UL
+
+/* Timer1 output used for the motor, OC1A is PD5 and OC1B is PD4 */
+#define PWM_TIMER1_CHANNEL_A                                            0u
+#define PWM_TIMER1_CHANNEL_B                                            1u
+#define PWM_TIMER1_CHANNEL_SELECT                                       PWM_TIMER1_CHANNEL_A
+
 #define TIMER0_START_COUNT_VALUE                                        0u
 /*
  * Timer setup definitions
  */
+#define TIMER0_OCR_DISCONNECTED                                          0x00
 #define TIMER0_FAST_PWM_OCR_NON_INVERTING                               0x02
+#define TIMER1_OCR_DISCONNECTED                                         0x00
+#define TIMER1_PWM_OCR_NON_INVERTING                                    0x02
 
 /*
  * Prescaler for the timer input
@@ -46,7 +77,44 @@ typedef union{
 #define TIMER0_PRESCALE_256                                             0x04
 #define TIMER0_PRESCALE_1024                                            0x05
 
-#define TIMER0_PRESCALE_SELECT                                          TIMER0_PRESCALE_64
+/*
+ * Counter period of the selected timer and mode, phase correct counts up and down
+ */
+#if (PWM_TIMER_SELECT == PWM_TIMER1)
+#define PWM_TOP_VALUE                                                   1023UL
+#else
+#define PWM_TOP_VALUE                                                   255UL
+#endif
+
+#if (PWM_MODE_SELECT == PWM_MODE_PHASE_CORRECT)
+#define PWM_PERIOD_COUNTS                                               (2UL * PWM_TOP_VALUE)
+#else
+#define PWM_PERIOD_COUNTS                                               (PWM_TOP_VALUE + 1UL)
+#endif
+
+#define PWM_CARRIER_AT_PRESCALE(PRESCALE)                               (F_CPU / ((PRESCALE) * PWM_PERIOD_COUNTS))
+
+/* Timer0 and Timer1 share the same clock select values */
+#if (PWM_CARRIER_AT_PRESCALE(1024UL) >= PWM_CARRIER_FREQUENCY_HZ)
+#define PWM_PRESCALE_SELECT                                             TIMER0_PRESCALE_1024
+#define PWM_PRESCALE_VALUE                                              1024UL
+#elif (PWM_CARRIER_AT_PRESCALE(256UL) >= PWM_CARRIER_FREQUENCY_HZ)
+#define PWM_PRESCALE_SELECT                                             TIMER0_PRESCALE_256
+#define PWM_PRESCALE_VALUE                                              256UL
+#elif (PWM_CARRIER_AT_PRESCALE(64UL) >= PWM_CARRIER_FREQUENCY_HZ)
+#define PWM_PRESCALE_SELECT                                             TIMER0_PRESCALE_64
+#define PWM_PRESCALE_VALUE                                              64UL
+#elif (PWM_CARRIER_AT_PRESCALE(8UL) >= PWM_CARRIER_FREQUENCY_HZ)
+#define PWM_PRESCALE_SELECT                                             TIMER0_PRESCALE_8
+#define PWM_PRESCALE_VALUE                                              8UL
+#else
+#define PWM_PRESCALE_SELECT                                             TIMER0_NO_PRESCALE
+#define PWM_PRESCALE_VALUE                                              1UL
+#endif
+
+#define PWM_CARRIER_ACTUAL_HZ                                           PWM_CARRIER_AT_PRESCALE(PWM_PRESCALE_VALUE)
+
+#define TIMER0_PRESCALE_SELECT                                          PWM_PRESCALE_SELECT
 
 /*
  * Duty Cycle Values
@@ -62,6 +130,21 @@ typedef union{
  */
 #define TIMER0_COUNT_REG_SIZE                                           0xFF
 
+/*
+ * Percent to OCR0 scaling without division or float:
+ * OCR0 = (duty * 653) >> 8 maps 0 - 100 % onto 0 - 255
+ */
+#define TIMER0_DUTY_SCALE_FACTOR                                        653u
+#define TIMER0_DUTY_SCALE_SHIFT                                         8u
+#define TIMER0_MAX_DUTY_CYCLE                                           100u
+
+/*
+ * OCR1 = (duty * 655) >> 6 maps 0 - 100 % onto 0 - 1023
+ */
+#define TIMER1_DUTY_SCALE_FACTOR                                        655u
+#define TIMER1_DUTY_SCALE_SHIFT                                         6u
+#define TIMER1_MAX_DUTY_CYCLE                                           100u
+
 /*
  * Register initialization 
  */
@@ -73,14 +156,48 @@ typedef union{
 #define TIMER0_OCR0_PORT_ID												PORTB_ID
 #define TIMER0_OCR0_PIN_ID												PIN3_ID
 
+#if (PWM_TIMER1_CHANNEL_SELECT == PWM_TIMER1_CHANNEL_B)
+#define TIMER1_OCR1_PORT_ID                                             PORTD_ID
+#define TIMER1_OCR1_PIN_ID                                              PIN4_ID
+#else
+#define TIMER1_OCR1_PORT_ID                                             PORTD_ID
+#define TIMER1_OCR1_PIN_ID                                              PIN5_ID
+#endif
+
 /*******************************************************
  *                  Function prototype
  *******************************************************/
 
 /*
- * Description: starts and sets PWM wave
+ * Description: sets up the OC0 pin and starts the timer in the selected PWM mode with 0% duty
+ */
+void PWM_Timer0_Init(void);
+
+/*
+ * Description: changes the duty cycle (percent) of the running PWM wave,
+ * only OCR0 is written so it is cheap enough to be called from an ISR
+ */
+void PWM_Timer0_SetDuty(uint8 pwm_duty_cycle);
+
+/*
+ * Description: sets up the OC1A/OC1B pin and starts Timer1 in 10-bit PWM mode with 0% duty
+ */
+void PWM_Timer1_Init(void);
+
+/*
+ * Description: changes the duty cycle (percent) of the Timer1 PWM wave
+ */
+void PWM_Timer1_SetDuty(uint8 pwm_duty_cycle);
+
+/*
+ * Description: starts the PWM timer chosen by PWM_TIMER_SELECT
+ */
+void PWM_init(void);
+
+/*
+ * Description: changes the duty cycle (percent) on the PWM timer chosen by PWM_TIMER_SELECT
  */
-void PWM_Timer0_Start(uint8 pwm_duty_cycle);
+void PWM_setDuty(uint8 pwm_duty_cycle);
 
 #endif	/* PWM_H */
 
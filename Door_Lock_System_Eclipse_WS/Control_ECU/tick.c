@@ -0,0 +1,138 @@
+/*
+ *  File: Source file for System Tick service
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile Tick_Type g_tick_count = 0;
+static void(*volatile g_tick_hooks[TICK_MAX_HOOKS])(void);
+static volatile uint8 g_tick_num_of_hooks = 0;
+/* remaining time of each software timer, 0 when the timer is free */
+static volatile uint16 g_tick_timer_remaining_ms[TICK_MAX_TIMERS];
+static void(*volatile g_tick_timer_callBacks[TICK_MAX_TIMERS])(void);
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Called by the timer driver each compare match
+ */
+static void Tick_callBack(void)
+{
+	uint8 hook_index, timer_index;
+	g_tick_count++;
+	for(hook_index = 0; hook_index < g_tick_num_of_hooks; hook_index++)
+	{
+		(*g_tick_hooks[hook_index])();
+	}
+	for(timer_index = 0; timer_index < TICK_MAX_TIMERS; timer_index++)
+	{
+		if(g_tick_timer_remaining_ms[timer_index] != 0)
+		{
+			g_tick_timer_remaining_ms[timer_index] -= TICK_PERIOD_MS;
+			if(g_tick_timer_remaining_ms[timer_index] == 0)
+			{
+				(*g_tick_timer_callBacks[timer_index])();
+			}
+		}
+	}
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void Tick_init(void)
+{
+	Timer_ConfigType tick_timer_config = {0, TICK_COMPARE_VALUE, TICK_TIMER_ID, TICK_TIMER_CLOCK, TIMER_COMPARE_MODE};
+	Timer_deInit(TICK_TIMER_ID);
+	Timer_setCallBack(Tick_callBack, TICK_TIMER_ID);
+	Timer_init(&tick_timer_config);
+}
+
+Tick_Type Tick_getTicks(void)
+{
+	Tick_Type ticks;
+	uint8 sreg_value = SREG;
+	/* 32-bit value is updated by the ISR so it must be read atomically */
+	cli();
+	ticks = g_tick_count;
+	SREG = sreg_value;
+	return ticks;
+}
+
+uint32 Tick_getMicros(void)
+{
+	Tick_Type ticks;
+	uint16 timer_count;
+	uint8 sreg_value = SREG;
+	cli();
+	timer_count = TICK_TIMER_COUNT_R;
+	ticks = g_tick_count;
+	/* the counter wrapped but the compare interrupt has not run yet */
+	if((TIFR & (1<<TICK_TIMER_COMPARE_FLAG)) && (timer_count < (TICK_COMPARE_VALUE / 2)))
+	{
+		ticks++;
+	}
+	SREG = sreg_value;
+	return (ticks * 1000UL * TICK_PERIOD_MS) + ((uint32)timer_count * TICK_US_PER_TIMER_COUNT);
+}
+
+Tick_Type Tick_elapsedSince(Tick_Type start_tick)
+{
+	return (Tick_getTicks() - start_tick);
+}
+
+boolean Tick_addHook(void(*a_hook_ptr)(void))
+{
+	uint8 sreg_value;
+	if(g_tick_num_of_hooks >= TICK_MAX_HOOKS)
+	{
+		return FALSE;
+	}
+	sreg_value = SREG;
+	cli();
+	g_tick_hooks[g_tick_num_of_hooks] = a_hook_ptr;
+	g_tick_num_of_hooks++;
+	SREG = sreg_value;
+	return TRUE;
+}
+
+uint8 Tick_startTimer(uint16 delay_ms, void(*a_callBack_ptr)(void))
+{
+	uint8 timer_index, sreg_value;
+	if(delay_ms == 0)
+	{
+		delay_ms = TICK_PERIOD_MS;
+	}
+	sreg_value = SREG;
+	cli();
+	for(timer_index = 0; timer_index < TICK_MAX_TIMERS; timer_index++)
+	{
+		if(g_tick_timer_remaining_ms[timer_index] == 0)
+		{
+			g_tick_timer_callBacks[timer_index] = a_callBack_ptr;
+			g_tick_timer_remaining_ms[timer_index] = delay_ms;
+			break;
+		}
+	}
+	SREG = sreg_value;
+	return (timer_index < TICK_MAX_TIMERS) ? timer_index : TICK_INVALID_TIMER;
+}
+
+void Tick_stopTimer(uint8 timer_id)
+{
+	uint8 sreg_value;
+	if(timer_id >= TICK_MAX_TIMERS)
+	{
+		return;
+	}
+	sreg_value = SREG;
+	cli();
+	g_tick_timer_remaining_ms[timer_id] = 0;
+	SREG = sreg_value;
+}
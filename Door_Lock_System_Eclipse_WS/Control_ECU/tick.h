@@ -0,0 +1,105 @@
+/*
+ *  File: Header file for System Tick service
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef TICK_H_
+#define TICK_H_
+
+#include "std_types.h"
+#include "timer.h"
+#include "pwm.h"
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+/* milliseconds since Tick_init(), wraps after ~49 days */
+typedef uint32 Tick_Type;
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/*
+ * The tick uses whichever of Timer0 / Timer1 is not driving the motor PWM,
+ * compare mode with prescaler 64 gives a 1 ms period on both
+ */
+#if (PWM_TIMER_SELECT == PWM_TIMER1)
+#define TICK_TIMER_ID					TIMER0
+#define TICK_TIMER_COUNT_R				TCNT0
+#define TICK_TIMER_COMPARE_FLAG			OCF0
+#else
+#define TICK_TIMER_ID					TIMER1
+#define TICK_TIMER_COUNT_R				TCNT1
+#define TICK_TIMER_COMPARE_FLAG			OCF1A
+#endif
+#define TICK_TIMER_CLOCK				F_CLK_PRESCALE_64
+#define TICK_TIMER_PRESCALE				64UL
+#define TICK_PERIOD_MS					1u
+#define TICK_COMPARE_VALUE				((uint16)((F_CPU / TICK_TIMER_PRESCALE / 1000UL) - 1))
+#define TICK_US_PER_TIMER_COUNT			((1000000UL * TICK_TIMER_PRESCALE) / F_CPU)
+
+/*
+ * Number of functions that can be attached to the tick interrupt,
+ * hooks run in interrupt context so they must be short and non-blocking
+ */
+#define TICK_MAX_HOOKS					6u
+
+/*
+ * One-shot software timers, the callback runs in interrupt context
+ * from the tick once the delay has passed
+ */
+#define TICK_MAX_TIMERS					4u
+#define TICK_INVALID_TIMER				0xFFu
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Starts the tick timer, must be called before any tick based module is used
+ */
+void Tick_init(void);
+
+/*
+ * Description:
+ * Returns the number of milliseconds passed since Tick_init()
+ */
+Tick_Type Tick_getTicks(void);
+
+/*
+ * Description:
+ * Returns a microsecond timestamp built from the tick count and the timer
+ * count, used to measure short latencies (wraps after ~71 minutes)
+ */
+uint32 Tick_getMicros(void);
+
+/*
+ * Description:
+ * Returns the number of milliseconds passed since the given tick value (wrap safe)
+ */
+Tick_Type Tick_elapsedSince(Tick_Type start_tick);
+
+/*
+ * Description:
+ * Attaches a function to be called every tick from the timer ISR
+ * returns FALSE if the hook table is full
+ */
+boolean Tick_addHook(void(*a_hook_ptr)(void));
+
+/*
+ * Description:
+ * Calls the given function once after delay_ms milliseconds,
+ * returns the timer id or TICK_INVALID_TIMER if all timers are busy
+ */
+uint8 Tick_startTimer(uint16 delay_ms, void(*a_callBack_ptr)(void));
+
+/*
+ * Description:
+ * Cancels a timer started by Tick_startTimer() before it expires
+ */
+void Tick_stopTimer(uint8 timer_id);
+
+#endif /* TICK_H_ */
@@ -10,6 +10,7 @@
 #include "avr/io.h" /* To use the UART Registers */
 #include "avr/interrupt.h"
 #include "common_macros.h" /* To use the macros like SET_BIT */
+#include "gpio.h"
 
 #if UART_RX_MODE_SELECT == UART_RX_INTERRUPT_ENABLE
 volatile uint8 g_uart_data;
@@ -23,6 +24,83 @@ ISR(USART_RXC_vect)
 {
 	g_uart_rxc_flag = UART_recieveByte();
 }
+#elif UART_RX_MODE_SELECT == UART_RX_RING_BUFFER_MODE
+static volatile uint8 g_uart_rx_buffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 g_uart_rx_head = 0;
+static volatile uint8 g_uart_rx_tail = 0;
+static volatile uint8 g_uart_rx_overruns = 0;
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+static volatile uint8 g_uart_own_address = UART_NO_ADDRESS;
+#endif
+
+ISR(USART_RXC_vect)
+{
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	uint8 is_address = BIT_IS_SET(UCSRB, RXB8); /* the 9th bit must be read before UDR */
+#endif
+	uint8 data = UDR; /* reading UDR clears the interrupt flag */
+	uint8 next_head = (uint8)((g_uart_rx_head + 1) & (UART_RX_BUFFER_SIZE - 1));
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if(is_address)
+	{
+		if(g_uart_own_address != UART_NO_ADDRESS)
+		{
+			/* TXC is cleared by writing one so it is masked out of the write back */
+			if((data == g_uart_own_address) || (data == UART_BROADCAST_ADDRESS))
+			{
+				UCSRA = (uint8)(UCSRA & ~((1<<TXC) | (1<<MPCM)));
+			}
+			else
+			{
+				UCSRA = (uint8)((UCSRA & ~(1<<TXC)) | (1<<MPCM));
+			}
+		}
+		return;
+	}
+#endif
+	if(next_head == g_uart_rx_tail)
+	{
+		g_uart_rx_overruns++; /* queue is full, the byte is dropped */
+		return;
+	}
+	g_uart_rx_buffer[g_uart_rx_head] = data;
+	g_uart_rx_head = next_head;
+}
+#endif
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+/*
+ * The last byte left the shift register, the bus is released for the other nodes
+ */
+ISR(USART_TXC_vect)
+{
+	GPIO_writePin(UART_RS485_DE_PORT_ID, UART_RS485_DE_PIN_ID, LOGIC_LOW);
+}
+
+/*
+ * Description :
+ * Drives the bus and starts sending a byte, TXC of the previous byte is
+ * cleared first so its interrupt can not release the bus under this one
+ */
+static void UART_transmit(uint8 data, uint8 is_address)
+{
+	uint8 sreg_value;
+	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+	sreg_value = SREG;
+	cli();
+	if(is_address)
+	{
+		SET_BIT(UCSRB, TXB8);
+	}
+	else
+	{
+		CLEAR_BIT(UCSRB, TXB8);
+	}
+	UCSRA |= (1<<TXC);
+	GPIO_writePin(UART_RS485_DE_PORT_ID, UART_RS485_DE_PIN_ID, LOGIC_HIGH);
+	UDR = data;
+	SREG = sreg_value;
+}
 #endif
 /*
  * Description :
@@ -47,7 +125,12 @@ void UART_init(const UART_ConfigType* Config_Ptr)
 	 * UCSZ2 = 0 For 8-bit data mode
 	 * RXB8 & TXB8 not used for 8-bit data mode
 	 ***********************************************************************/
-#if UART_RX_MODE_SELECT == UART_RX_INTERRUPT_ENABLE
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	/* TXCIE releases the transceiver after the last byte */
+	UCSRB = (1<<RXEN) | (1<<TXEN) | (1<<RXCIE) | (1<<TXCIE);
+	GPIO_setupPinDirection(UART_RS485_DE_PORT_ID, UART_RS485_DE_PIN_ID, PIN_OUTPUT);
+	GPIO_writePin(UART_RS485_DE_PORT_ID, UART_RS485_DE_PIN_ID, LOGIC_LOW);
+#elif (UART_RX_MODE_SELECT == UART_RX_INTERRUPT_ENABLE) || (UART_RX_MODE_SELECT == UART_RX_RING_BUFFER_MODE)
 	UCSRB = (1<<RXEN) | (1<<TXEN) | (1<<RXCIE);
 #else
 	UCSRB = (1<<RXEN) | (1<<TXEN);
@@ -96,6 +179,9 @@ void UART_init(const UART_ConfigType* Config_Ptr)
  */
 void UART_sendByte(const uint8 data)
 {
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	UART_transmit(data, FALSE);
+#else
 	/*
 	 * UDRE flag is set when the Tx buffer (UDR) is empty and ready for
 	 * transmitting a new byte so wait until this flag is set to one
@@ -107,6 +193,7 @@ void UART_sendByte(const uint8 data)
 	 * the UDR register is not empty now
 	 */
 	UDR = data;
+#endif
 }
 
 /*
@@ -121,6 +208,13 @@ uint8 UART_recieveByte(void)
 	 * when using interrupt mode the return acts as a flag
 	 */
 	return TRUE;
+#elif UART_RX_MODE_SELECT == UART_RX_RING_BUFFER_MODE
+	uint8 data;
+	/* wait until the RX interrupt queues a byte */
+	while(g_uart_rx_head == g_uart_rx_tail){}
+	data = g_uart_rx_buffer[g_uart_rx_tail];
+	g_uart_rx_tail = (uint8)((g_uart_rx_tail + 1) & (UART_RX_BUFFER_SIZE - 1));
+	return data;
 #else
 	/* RXC flag is set when the UART receive data so wait until this flag is set to one */
 	while(BIT_IS_CLEAR(UCSRA,RXC)){}
@@ -133,6 +227,21 @@ uint8 UART_recieveByte(void)
 #endif
 }
 
+/*
+ * Description :
+ * Returns TRUE if a received byte is waiting to be read, never blocks
+ */
+boolean UART_isByteReceived(void)
+{
+#if UART_RX_MODE_SELECT == UART_RX_INTERRUPT_ENABLE
+	return (g_uart_rxc_flag == TRUE);
+#elif UART_RX_MODE_SELECT == UART_RX_RING_BUFFER_MODE
+	return (g_uart_rx_head != g_uart_rx_tail);
+#else
+	return (BIT_IS_SET(UCSRA,RXC) ? TRUE : FALSE);
+#endif
+}
+
 /*
  * Description :
  * Send the required string through UART to the other UART device.
@@ -149,6 +258,49 @@ void UART_sendString(const uint8 *Str)
 	}
 }
 
+#if UART_RX_MODE_SELECT == UART_RX_RING_BUFFER_MODE
+/*
+ * Description :
+ * Returns the number of bytes dropped because the receive queue was full
+ */
+uint8 UART_getRxOverruns(void)
+{
+	return g_uart_rx_overruns;
+}
+#endif
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+/*
+ * Description :
+ * Makes a node receive only the bytes following its own address byte,
+ * UART_NO_ADDRESS receives everything
+ */
+void UART_setAddress(uint8 address)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	g_uart_own_address = address;
+	if(address == UART_NO_ADDRESS)
+	{
+		UCSRA = (uint8)(UCSRA & ~((1<<TXC) | (1<<MPCM)));
+	}
+	else
+	{
+		UCSRA = (uint8)((UCSRA & ~(1<<TXC)) | (1<<MPCM)); /* waiting for an address byte */
+	}
+	SREG = sreg_value;
+}
+
+/*
+ * Description :
+ * Sends an address byte selecting the node the next bytes are for
+ */
+void UART_sendAddress(uint8 address)
+{
+	UART_transmit(address, TRUE);
+}
+#endif
+
 /*
  * Description :
  * Receive the required string until the '#' symbol through UART from the other UART device.
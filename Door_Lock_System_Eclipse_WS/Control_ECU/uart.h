@@ -51,11 +51,52 @@ typedef struct {
  *******************************************************************************/
 #define UART_RX_INTERRUPT_ENABLE			1u
 #define UART_RX_NORMAL_MODE					0u
+/*
+ * Received bytes are queued by the RX interrupt so none is lost while the
+ * application is busy, the receive functions read from the queue
+ */
+#define UART_RX_RING_BUFFER_MODE			2u
+
+#define UART_RX_MODE_SELECT					UART_RX_RING_BUFFER_MODE
 
-#define UART_RX_MODE_SELECT					UART_RX_NORMAL_MODE
+/* must be a power of two */
+#define UART_RX_BUFFER_SIZE					16u
 
 #define UART_RX_STRING_BREAK				('#')
 
+/*
+ * Point-to-point link or RS-485 multi-drop bus. On the bus the 9th data bit
+ * marks an address byte sent by the HMI ECU, a Control ECU listens in the
+ * multi-processor communication mode (MPCM) so the bytes sent to the other
+ * nodes are dropped by the hardware. The receive queue is needed for it
+ */
+#define UART_BUS_POINT_TO_POINT				0u
+#define UART_BUS_MULTI_DROP					1u
+
+#define UART_BUS_MODE_SELECT				UART_BUS_POINT_TO_POINT
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+#define UART_BUS_DATA_BITS					DATA_9_BIT
+#else
+#define UART_BUS_DATA_BITS					DATA_8_BIT
+#endif
+
+/*
+ * RS-485 transceiver driver enable, high while this node transmits, the
+ * receiver enable (/RE) is wired to it so the node does not hear itself
+ */
+#define UART_RS485_DE_PORT_ID				PORTD_ID
+#define UART_RS485_DE_PIN_ID				PIN2_ID
+
+/* the master has no address, it only sends them */
+#define UART_NO_ADDRESS						0u
+/* selects every node at once */
+#define UART_BROADCAST_ADDRESS				0xFFu
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP) && (UART_RX_MODE_SELECT != UART_RX_RING_BUFFER_MODE)
+#error "The multi-drop bus filters the address bytes in the receive queue interrupt"
+#endif
+
 #if UART_RX_MODE_SELECT == UART_RX_INTERRUPT_ENABLE
 /*
  * Global Variables
@@ -88,12 +129,41 @@ void UART_sendByte(const uint8 data);
  */
 uint8 UART_recieveByte(void);
 
+/*
+ * Description :
+ * Returns TRUE if a received byte is waiting to be read, never blocks
+ */
+boolean UART_isByteReceived(void);
+
 /*
  * Description :
  * Send the required string through UART to the other UART device.
  */
 void UART_sendString(const uint8 *Str);
 
+#if UART_RX_MODE_SELECT == UART_RX_RING_BUFFER_MODE
+/*
+ * Description :
+ * Returns the number of bytes dropped because the receive queue was full
+ */
+uint8 UART_getRxOverruns(void);
+#endif
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+/*
+ * Description :
+ * Makes a node receive only the bytes following its own address byte,
+ * UART_NO_ADDRESS receives everything
+ */
+void UART_setAddress(uint8 address);
+
+/*
+ * Description :
+ * Sends an address byte selecting the node the next bytes are for
+ */
+void UART_sendAddress(uint8 address);
+#endif
+
 #if UART_RX_MODE_SELECT == UART_RX_INTERRUPT_ENABLE
 #else
 /*
@@ -7,7 +7,9 @@ C_SRCS += \
 ../gpio.c \
 ../keypad.c \
 ../lcd.c \
+../link.c \
 ../main.c \
+../tick.c \
 ../timer.c \
 ../uart.c 
 
@@ -15,7 +17,9 @@ OBJS += \
 ./gpio.o \
 ./keypad.o \
 ./lcd.o \
+./link.o \
 ./main.o \
+./tick.o \
 ./timer.o \
 ./uart.o 
 
@@ -23,7 +27,9 @@ C_DEPS += \
 ./gpio.d \
 ./keypad.d \
 ./lcd.d \
+./link.d \
 ./main.d \
+./tick.d \
 ./timer.d \
 ./uart.d 
 
@@ -11,145 +11,359 @@
  *******************************************************************************/
 #include "keypad.h"
 #include "gpio.h"
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 
 /*******************************************************************************
- *                      Functions Prototypes(Private)                          *
+ *                           Global Variables(Private)                         *
  *******************************************************************************/
 
-#if (KEYPAD_NUM_COLS == 3)
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x3 keypad
+ * Row and column to key code table, kept in flash and read with pgm_read_byte
  */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number);
+#if (KEYPAD_NUM_COLS == 3)
+static const uint8 g_keypad_keyMap[KEYPAD_NUM_ROWS][KEYPAD_NUM_COLS] PROGMEM = {
+		{1,   2, 3  },
+		{4,   5, 6  },
+		{7,   8, 9  },
+		{'*', 0, '#'}
+};
 #elif (KEYPAD_NUM_COLS == 4)
+static const uint8 g_keypad_keyMap[KEYPAD_NUM_ROWS][KEYPAD_NUM_COLS] PROGMEM = {
+		{7,  8, 9,   '%'},
+		{4,  5, 6,   '*'},
+		{1,  2, 3,   '-'},
+		{13, 0, '=', '+'}  /* 13 is the ASCII of Enter */
+};
+#endif
+
+static KEYPAD_ConfigType g_keypad_config = {
+		KEYPAD_DEFAULT_DEBOUNCE_MS,
+		KEYPAD_DEFAULT_LONG_PRESS_MS,
+		KEYPAD_DEFAULT_REPEAT_DELAY_MS,
+		KEYPAD_DEFAULT_REPEAT_RATE_MS
+};
+
 /*
- * Function responsible for mapping the switch number in the keypad to
- * its corresponding functional number in the proteus for 4x4 keypad
+ * Events are pushed by the tick ISR and popped by the application,
+ * one producer and one consumer so the 8-bit indices need no locking
  */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number);
-#endif
+static volatile KEYPAD_EventType g_keypad_event_queue[KEYPAD_EVENT_QUEUE_SIZE];
+static volatile uint8 g_keypad_queue_head = 0;
+static volatile uint8 g_keypad_queue_tail = 0;
+
+static volatile KEYPAD_TypingStatsType g_keypad_typing_stats;
+static Tick_Type g_keypad_last_press_tick;
+
+/* Debounced bitmap of the pressed keys */
+static volatile uint16 g_keypad_current_matrix = 0;
+
+/* Scanner state, only touched from the tick ISR */
+static uint8 g_keypad_scan_ticks = 0;
+static uint16 g_keypad_candidate_matrix = 0;
+static uint16 g_keypad_stable_time = 0;
+static uint16 g_keypad_reported_matrix = 0; /* keys that generated a press event */
+static uint8 g_keypad_active_key_index = KEYPAD_NO_KEY; /* last pressed key, the one that long-presses and repeats */
+static uint16 g_keypad_held_time = 0;
+static uint16 g_keypad_next_repeat_time = 0;
+static boolean g_keypad_long_press_sent = FALSE;
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Scan the whole matrix once into a bitmap,
+ * returns FALSE if the pattern is ambiguous because of ghosting
+ */
+static boolean KEYPAD_scan(uint16* matrix_Ptr);
+
+/*
+ * Debounce the scanned matrix and generate the keypad events, called every tick
+ */
+static void KEYPAD_tickHook(void);
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
  *******************************************************************************/
 
-uint8 KEYPAD_getPressedKey(void)
+void KEYPAD_init(const KEYPAD_ConfigType* Config_Ptr)
 {
-	uint8 col,row, lcd_isPressed;
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+2, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+3, PIN_INPUT);
-
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+1, PIN_INPUT);
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+2, PIN_INPUT);
-#if(KEYPAD_NUM_COLS == 4)
-	GPIO_setupPinDirection(KEYPAD_COL_PORT_ID, KEYPAD_FIRST_COL_PIN_ID+3, PIN_INPUT);
+	if(Config_Ptr != NULL_PTR)
+	{
+		g_keypad_config = *Config_Ptr;
+	}
+
+	/* All rows and columns are inputs, a row only becomes an output while it is scanned */
+	KEYPAD_PORT_DIR_R &= (uint8)(~(KEYPAD_ROW_MASK | KEYPAD_COL_MASK));
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+	/* rows output zero once their direction is switched to output */
+	KEYPAD_PORT_DATA_R &= (uint8)(~KEYPAD_ROW_MASK);
 #endif
-	while(1)
+
+	Tick_addHook(KEYPAD_tickHook);
+}
+
+boolean KEYPAD_getEvent(KEYPAD_EventType* event_Ptr)
+{
+	uint8 tail = g_keypad_queue_tail;
+	if(tail == g_keypad_queue_head)
+	{
+		return FALSE;
+	}
+	event_Ptr->key = g_keypad_event_queue[tail].key;
+	event_Ptr->kind = g_keypad_event_queue[tail].kind;
+	event_Ptr->held_time_ms = g_keypad_event_queue[tail].held_time_ms;
+	g_keypad_queue_tail = (uint8)((tail + 1) % KEYPAD_EVENT_QUEUE_SIZE);
+	return TRUE;
+}
+
+uint8 KEYPAD_getPressedKey(void)
+{
+	KEYPAD_EventType keypad_event;
+	for(;;)
 	{
-		for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
+		if(KEYPAD_getEvent(&keypad_event) && (keypad_event.kind == KEYPAD_EVENT_PRESS))
 		{
-			/* 
-			 * Each time setup the direction for all keypad port as input pins,
-			 * except this row will be output pin
-			 */
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_OUTPUT);
+			return keypad_event.key;
+		}
+	}
+}
+
+uint16 KEYPAD_getMatrix(void)
+{
+	uint16 matrix;
+	uint8 sreg_value = SREG;
+	cli();
+	matrix = g_keypad_current_matrix;
+	SREG = sreg_value;
+	return matrix;
+}
+
+uint8 KEYPAD_getPressedKeys(uint8* keys_Ptr, uint8 max_keys)
+{
+	uint8 key_index, num_of_keys = 0;
+	uint16 matrix = KEYPAD_getMatrix();
+	for(key_index = 0; (key_index < KEYPAD_NUM_KEYS) && (num_of_keys < max_keys); key_index++)
+	{
+		if(matrix & (1u << key_index))
+		{
+			keys_Ptr[num_of_keys++] = pgm_read_byte(&g_keypad_keyMap[0][0] + key_index);
+		}
+	}
+	return num_of_keys;
+}
+
+void KEYPAD_getTypingStats(KEYPAD_TypingStatsType* stats_Ptr)
+{
+	uint8 sreg_value = SREG;
+	cli();
+	stats_Ptr->press_count = g_keypad_typing_stats.press_count;
+	stats_Ptr->last_interval_ms = g_keypad_typing_stats.last_interval_ms;
+	stats_Ptr->min_interval_ms = g_keypad_typing_stats.min_interval_ms;
+	stats_Ptr->total_interval_ms = g_keypad_typing_stats.total_interval_ms;
+	g_keypad_typing_stats.press_count = 0;
+	g_keypad_typing_stats.last_interval_ms = 0;
+	g_keypad_typing_stats.min_interval_ms = 0xFFFF;
+	g_keypad_typing_stats.total_interval_ms = 0;
+	SREG = sreg_value;
+}
+
+/*******************************************************************************
+ *                      Functions Definitions(Private)                         *
+ *******************************************************************************/
+
+static void KEYPAD_pushEvent(uint8 key, KEYPAD_EventKindType kind, uint16 held_time_ms)
+{
+	uint8 head = g_keypad_queue_head;
+	uint8 next_head = (uint8)((head + 1) % KEYPAD_EVENT_QUEUE_SIZE);
+	if(next_head == g_keypad_queue_tail)
+	{
+		return; /* queue is full, the application is not reading so drop the event */
+	}
+	g_keypad_event_queue[head].key = key;
+	g_keypad_event_queue[head].kind = kind;
+	g_keypad_event_queue[head].held_time_ms = held_time_ms;
+	g_keypad_queue_head = next_head;
+}
+
+static void KEYPAD_updateTypingStats(void)
+{
+	Tick_Type now = Tick_getTicks();
+	Tick_Type interval = now - g_keypad_last_press_tick;
+	g_keypad_last_press_tick = now;
+
+	if(g_keypad_typing_stats.press_count != 0)
+	{
+		if(interval > 0xFFFF)
+		{
+			interval = 0xFFFF;
+		}
+		g_keypad_typing_stats.last_interval_ms = (uint16)interval;
+		g_keypad_typing_stats.total_interval_ms += interval;
+		if(interval < g_keypad_typing_stats.min_interval_ms)
+		{
+			g_keypad_typing_stats.min_interval_ms = (uint16)interval;
+		}
+	}
+	else
+	{
+		g_keypad_typing_stats.min_interval_ms = 0xFFFF;
+	}
+	if(g_keypad_typing_stats.press_count < 0xFF)
+	{
+		g_keypad_typing_stats.press_count++;
+	}
+}
+
+static void KEYPAD_tickHook(void)
+{
+	uint16 scanned_matrix, pressed_matrix, released_matrix;
+	uint8 key_index;
+
+	g_keypad_scan_ticks++;
+	if(g_keypad_scan_ticks < (KEYPAD_SCAN_PERIOD_MS / TICK_PERIOD_MS))
+	{
+		return;
+	}
+	g_keypad_scan_ticks = 0;
+
+	if(KEYPAD_scan(&scanned_matrix) == FALSE)
+	{
+		return; /* ghosted scan, the real keys can't be known so drop it */
+	}
+
+	/* The scanned matrix must stay the same for the debounce time to be accepted */
+	if(scanned_matrix != g_keypad_candidate_matrix)
+	{
+		g_keypad_candidate_matrix = scanned_matrix;
+		g_keypad_stable_time = 0;
+	}
+	else if(g_keypad_stable_time < g_keypad_config.debounce_ms)
+	{
+		g_keypad_stable_time += KEYPAD_SCAN_PERIOD_MS;
+	}
+	if(g_keypad_stable_time < g_keypad_config.debounce_ms)
+	{
+		return;
+	}
 
-			/* Set/Clear the row output pin */
-			GPIO_writePin(KEYPAD_ROW_PORT_ID, KEYPAD_FIRST_ROW_PIN_ID+row, KEYPAD_BUTTON_PRESSED);
+	if(g_keypad_candidate_matrix != g_keypad_current_matrix)
+	{
+		pressed_matrix = g_keypad_candidate_matrix & (uint16)(~g_keypad_current_matrix);
+		released_matrix = g_keypad_current_matrix & (uint16)(~g_keypad_candidate_matrix) & g_keypad_reported_matrix;
+		g_keypad_current_matrix = g_keypad_candidate_matrix;
 
-			for(col=0 ; col<KEYPAD_NUM_COLS ; col++) /* loop for columns */
+		for(key_index = 0; (key_index < KEYPAD_NUM_KEYS) && (released_matrix != 0); key_index++)
+		{
+			if(released_matrix & (1u << key_index))
 			{
-				/* Check if the switch is pressed in this column */
-				GPIO_readPin(KEYPAD_COL_PORT_ID,KEYPAD_FIRST_COL_PIN_ID+col, &lcd_isPressed);
-				if( lcd_isPressed == KEYPAD_BUTTON_PRESSED)
+				released_matrix &= (uint16)(~(1u << key_index));
+				g_keypad_reported_matrix &= (uint16)(~(1u << key_index));
+				if(key_index == g_keypad_active_key_index)
+				{
+					KEYPAD_pushEvent(pgm_read_byte(&g_keypad_keyMap[0][0] + key_index), KEYPAD_EVENT_RELEASE, g_keypad_held_time);
+					g_keypad_active_key_index = KEYPAD_NO_KEY;
+				}
+				else
 				{
-					#if (KEYPAD_NUM_COLS == 3)
-						return KEYPAD_4x3_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#elif (KEYPAD_NUM_COLS == 4)
-						return KEYPAD_4x4_adjustKeyNumber((row*KEYPAD_NUM_COLS)+col+1);
-					#endif
+					KEYPAD_pushEvent(pgm_read_byte(&g_keypad_keyMap[0][0] + key_index), KEYPAD_EVENT_RELEASE, 0);
 				}
 			}
-			GPIO_setupPinDirection(KEYPAD_ROW_PORT_ID,KEYPAD_FIRST_ROW_PIN_ID+row,PIN_INPUT);
-			_delay_ms(10); /* Add small delay to fix CPU load issue in proteus */
 		}
-	}	
-}
 
-#if (KEYPAD_NUM_COLS == 3)
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x3 shape
- */
-static uint8 KEYPAD_4x3_adjustKeyNumber(uint8 button_number)
-{
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 10: keypad_button = '*'; // ASCII Code of *
-				 break;
-		case 11: keypad_button = 0;
-				 break;
-		case 12: keypad_button = '#'; // ASCII Code of #
-				 break;
-		default: keypad_button = button_number;
-				break;
+		if((pressed_matrix & (pressed_matrix - 1)) != 0)
+		{
+			/*
+			 * More than one key went down together, which of them was meant
+			 * can't be known so none of them is reported as a press
+			 */
+			KEYPAD_pushEvent(KEYPAD_NO_KEY, KEYPAD_EVENT_CHORD, 0);
+		}
+		else if(pressed_matrix != 0)
+		{
+			/* a single new key, other keys may still be held (rollover typing) */
+			for(key_index = 0; (pressed_matrix & (1u << key_index)) == 0; key_index++){}
+			g_keypad_reported_matrix |= pressed_matrix;
+			g_keypad_active_key_index = key_index;
+			g_keypad_held_time = 0;
+			g_keypad_next_repeat_time = g_keypad_config.repeat_delay_ms;
+			g_keypad_long_press_sent = FALSE;
+			KEYPAD_pushEvent(pgm_read_byte(&g_keypad_keyMap[0][0] + key_index), KEYPAD_EVENT_PRESS, 0);
+			KEYPAD_updateTypingStats();
+		}
 	}
-	return keypad_button;
-} 
+	else if(g_keypad_active_key_index != KEYPAD_NO_KEY)
+	{
+		/* key is still held, saturate instead of wrapping for very long holds */
+		if(g_keypad_held_time <= (0xFFFF - KEYPAD_SCAN_PERIOD_MS))
+		{
+			g_keypad_held_time += KEYPAD_SCAN_PERIOD_MS;
+		}
 
-#elif (KEYPAD_NUM_COLS == 4)
+		if((g_keypad_long_press_sent == FALSE) && (g_keypad_config.long_press_ms != 0) &&
+				(g_keypad_held_time >= g_keypad_config.long_press_ms))
+		{
+			g_keypad_long_press_sent = TRUE;
+			KEYPAD_pushEvent(pgm_read_byte(&g_keypad_keyMap[0][0] + g_keypad_active_key_index), KEYPAD_EVENT_LONG_PRESS, g_keypad_held_time);
+		}
 
-/*
- * Description :
- * Update the keypad pressed button value with the correct one in keypad 4x4 shape
- */
-static uint8 KEYPAD_4x4_adjustKeyNumber(uint8 button_number)
+		if((g_keypad_config.repeat_delay_ms != 0) && (g_keypad_config.repeat_rate_ms != 0) &&
+				(g_keypad_held_time >= g_keypad_next_repeat_time))
+		{
+			g_keypad_next_repeat_time += g_keypad_config.repeat_rate_ms;
+			KEYPAD_pushEvent(pgm_read_byte(&g_keypad_keyMap[0][0] + g_keypad_active_key_index), KEYPAD_EVENT_REPEAT, g_keypad_held_time);
+		}
+	}
+}
+
+static boolean KEYPAD_scan(uint16* matrix_Ptr)
 {
-	uint8 keypad_button = 0;
-	switch(button_number)
-	{
-		case 1: keypad_button = 7;
-				break;
-		case 2: keypad_button = 8;
-				break;
-		case 3: keypad_button = 9;
-				break;
-		case 4: keypad_button = '%'; // ASCII Code of %
-				break;
-		case 5: keypad_button = 4;
-				break;
-		case 6: keypad_button = 5;
-				break;
-		case 7: keypad_button = 6;
-				break;
-		case 8: keypad_button = '*'; /* ASCII Code of '*' */
-				break;
-		case 9: keypad_button = 1;
-				break;
-		case 10: keypad_button = 2;
-				break;
-		case 11: keypad_button = 3;
-				break;
-		case 12: keypad_button = '-'; /* ASCII Code of '-' */
-				break;
-		case 13: keypad_button = 13;  /* ASCII of Enter */
-				break;
-		case 14: keypad_button = 0;
-				break;
-		case 15: keypad_button = '='; /* ASCII Code of '=' */
-				break;
-		case 16: keypad_button = '+'; /* ASCII Code of '+' */
-				break;
-		default: keypad_button = button_number;
-				break;
-	}
-	return keypad_button;
-} 
+	uint8 row, other_row, shared_columns;
+	uint8 row_columns[KEYPAD_NUM_ROWS];
+	uint16 matrix = 0;
+	for(row=0 ; row<KEYPAD_NUM_ROWS ; row++) /* loop for rows */
+	{
+		/* Only this row is an output, every other keypad pin is left as input */
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+		KEYPAD_PORT_DIR_R = (KEYPAD_PORT_DIR_R & (uint8)(~KEYPAD_ROW_MASK)) | (uint8)(1 << (KEYPAD_FIRST_ROW_PIN_ID+row));
+#else
+		KEYPAD_PORT_DATA_R = (KEYPAD_PORT_DATA_R & (uint8)(~KEYPAD_ROW_MASK)) | (uint8)(1 << (KEYPAD_FIRST_ROW_PIN_ID+row));
+		KEYPAD_PORT_DIR_R = (KEYPAD_PORT_DIR_R & (uint8)(~KEYPAD_ROW_MASK)) | (uint8)(1 << (KEYPAD_FIRST_ROW_PIN_ID+row));
+#endif
+		_delay_us(KEYPAD_ROW_SETTLE_TIME_US);
 
+		/* Sample all the columns of this row at once */
+#if (KEYPAD_BUTTON_PRESSED == LOGIC_LOW)
+		row_columns[row] = (uint8)((~KEYPAD_PORT_STATS_R & KEYPAD_COL_MASK) >> KEYPAD_FIRST_COL_PIN_ID);
+#else
+		row_columns[row] = (uint8)((KEYPAD_PORT_STATS_R & KEYPAD_COL_MASK) >> KEYPAD_FIRST_COL_PIN_ID);
+#endif
+		matrix |= (uint16)row_columns[row] << (row * KEYPAD_NUM_COLS);
+	}
+	KEYPAD_PORT_DIR_R &= (uint8)(~KEYPAD_ROW_MASK);
+#if (KEYPAD_BUTTON_PRESSED != LOGIC_LOW)
+	KEYPAD_PORT_DATA_R &= (uint8)(~KEYPAD_ROW_MASK);
 #endif
+
+	/*
+	 * Without diodes three keys on the corners of a rectangle make the fourth
+	 * corner read as pressed, so two rows sharing two or more columns can't be trusted
+	 */
+	for(row=0 ; row<(KEYPAD_NUM_ROWS-1) ; row++)
+	{
+		for(other_row=row+1 ; other_row<KEYPAD_NUM_ROWS ; other_row++)
+		{
+			shared_columns = row_columns[row] & row_columns[other_row];
+			if((shared_columns & (shared_columns - 1)) != 0)
+			{
+				return FALSE;
+			}
+		}
+	}
+	*matrix_Ptr = matrix;
+	return TRUE;
+}
@@ -14,6 +14,7 @@
 #define KEYPAD_H_
 
 #include "std_types.h"
+#include "gpio.h"
 
 /*******************************************************************************
  *                                Definitions                                  *
@@ -30,18 +31,140 @@
 #define KEYPAD_COL_PORT_ID                PORTB_ID
 #define KEYPAD_FIRST_COL_PIN_ID           PIN4_ID
 
+#if (KEYPAD_ROW_PORT_ID != KEYPAD_COL_PORT_ID)
+#error "Keypad rows and columns should be connected to the same port"
+#endif
+
+/*
+ * Registers of the keypad port, rows and columns share one port so a row is
+ * driven with one masked write and all the columns are sampled with one read
+ */
+#if (KEYPAD_ROW_PORT_ID == PORTA_ID)
+#define KEYPAD_PORT_DATA_R                GPIO_PORTA_DATA_R
+#define KEYPAD_PORT_DIR_R                 GPIO_PORTA_DIR_R
+#define KEYPAD_PORT_STATS_R               GPIO_PORTA_STATS_R
+#elif (KEYPAD_ROW_PORT_ID == PORTB_ID)
+#define KEYPAD_PORT_DATA_R                GPIO_PORTB_DATA_R
+#define KEYPAD_PORT_DIR_R                 GPIO_PORTB_DIR_R
+#define KEYPAD_PORT_STATS_R               GPIO_PORTB_STATS_R
+#elif (KEYPAD_ROW_PORT_ID == PORTC_ID)
+#define KEYPAD_PORT_DATA_R                GPIO_PORTC_DATA_R
+#define KEYPAD_PORT_DIR_R                 GPIO_PORTC_DIR_R
+#define KEYPAD_PORT_STATS_R               GPIO_PORTC_STATS_R
+#elif (KEYPAD_ROW_PORT_ID == PORTD_ID)
+#define KEYPAD_PORT_DATA_R                GPIO_PORTD_DATA_R
+#define KEYPAD_PORT_DIR_R                 GPIO_PORTD_DIR_R
+#define KEYPAD_PORT_STATS_R               GPIO_PORTD_STATS_R
+#else
+#error "Keypad port ID is not a valid GPIO port"
+#endif
+
+#define KEYPAD_ROW_MASK                   ((uint8)(((1u << KEYPAD_NUM_ROWS) - 1) << KEYPAD_FIRST_ROW_PIN_ID))
+#define KEYPAD_COL_MASK                   ((uint8)(((1u << KEYPAD_NUM_COLS) - 1) << KEYPAD_FIRST_COL_PIN_ID))
+
+/* Time for the column inputs to follow the driven row before they are sampled */
+#define KEYPAD_ROW_SETTLE_TIME_US         1
+
 /* Keypad button logic configurations */
 #define KEYPAD_BUTTON_PRESSED            LOGIC_LOW
 #define KEYPAD_BUTTON_RELEASED           LOGIC_HIGH
 
+/* Returned when no key is pressed, 0 can't be used as it is the '0' button */
+#define KEYPAD_NO_KEY                    0xFFu
+
+/* Each key has one bit in the matrix bitmap, bit index = (row * KEYPAD_NUM_COLS) + col */
+#define KEYPAD_NUM_KEYS                  (KEYPAD_NUM_ROWS * KEYPAD_NUM_COLS)
+
+/* The matrix is scanned from the system tick once every scan period */
+#define KEYPAD_SCAN_PERIOD_MS            10u
+
+/* Default event thresholds in milliseconds, a zero repeat delay disables auto-repeat */
+#define KEYPAD_DEFAULT_DEBOUNCE_MS       20u
+#define KEYPAD_DEFAULT_LONG_PRESS_MS     1000u
+#define KEYPAD_DEFAULT_REPEAT_DELAY_MS   500u
+#define KEYPAD_DEFAULT_REPEAT_RATE_MS    150u
+
+/* Number of events that can wait in the queue before new ones are dropped */
+#define KEYPAD_EVENT_QUEUE_SIZE          8u
+
+/*******************************************************************************
+ *                               Types Declaration                             *
+ *******************************************************************************/
+typedef enum
+{
+	KEYPAD_EVENT_PRESS,
+	KEYPAD_EVENT_RELEASE,
+	KEYPAD_EVENT_LONG_PRESS,
+	KEYPAD_EVENT_REPEAT,
+	KEYPAD_EVENT_CHORD /* several keys went down in the same scan, read them with KEYPAD_getPressedKeys() */
+}KEYPAD_EventKindType;
+
+typedef struct
+{
+	uint8 key;
+	KEYPAD_EventKindType kind;
+	uint16 held_time_ms; /* time the key has been held, zero for press and chord events */
+}KEYPAD_EventType;
+
+typedef struct
+{
+	uint16 debounce_ms;
+	uint16 long_press_ms;
+	uint16 repeat_delay_ms;
+	uint16 repeat_rate_ms;
+}KEYPAD_ConfigType;
+
+/*
+ * Typing rate information collected from press events,
+ * used by the application to throttle machine-speed password guessing
+ */
+typedef struct
+{
+	uint8 press_count;
+	uint16 last_interval_ms;
+	uint16 min_interval_ms;
+	uint32 total_interval_ms;
+}KEYPAD_TypingStatsType;
+
 /*******************************************************************************
  *                      Functions Prototypes                                   *
  *******************************************************************************/
 
 /*
  * Description :
- * Get the Keypad pressed button
+ * Setup the keypad pins and attach the scanner to the system tick,
+ * passing NULL_PTR uses the default thresholds
+ */
+void KEYPAD_init(const KEYPAD_ConfigType* Config_Ptr);
+
+/*
+ * Description :
+ * Get the next keypad event without waiting, returns FALSE if no event is queued
+ */
+boolean KEYPAD_getEvent(KEYPAD_EventType* event_Ptr);
+
+/*
+ * Description :
+ * Wait for a new key press and return the pressed button
  */
 uint8 KEYPAD_getPressedKey(void);
 
+/*
+ * Description :
+ * Get the debounced matrix bitmap of all the pressed keys
+ */
+uint16 KEYPAD_getMatrix(void);
+
+/*
+ * Description :
+ * Fill the given array with the codes of all the pressed keys and return their number
+ */
+uint8 KEYPAD_getPressedKeys(uint8* keys_Ptr, uint8 max_keys);
+
+/*
+ * Description :
+ * Read and clear the typing rate statistics
+ */
+void KEYPAD_getTypingStats(KEYPAD_TypingStatsType* stats_Ptr);
+
 #endif /* KEYPAD_H_ */
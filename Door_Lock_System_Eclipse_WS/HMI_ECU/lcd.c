@@ -12,10 +12,96 @@
 
 #include <util/delay.h> /* For the delay functions */
 #include "common_macros.h" /* For GET_BIT Macro */
-#include <stdlib.h>
-#include <stdio.h>
+#include <avr/pgmspace.h>
 #include "lcd.h"
 #include "gpio.h"
+#include "tick.h"
+
+/*******************************************************************************
+ *                           Global Variables(Private)                         *
+ *******************************************************************************/
+
+/* DDRAM address of the first column of each row */
+static const uint8 g_lcd_row_address[4] PROGMEM = {0x00, 0x40, 0x10, 0x50};
+
+/* Progress bar glyphs with 1 to 5 filled columns */
+static const uint8 g_lcd_progress_glyphs[LCD_PROGRESS_STEPS_PER_CELL * LCD_GLYPH_HEIGHT] PROGMEM = {
+		0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00,
+		0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00,
+		0x00, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x00,
+		0x00, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x00,
+		0x00, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x00
+};
+
+/* Progress bar position */
+static uint8 g_lcd_progress_row = 0;
+static uint8 g_lcd_progress_col = 0;
+static uint8 g_lcd_progress_width = 0;
+static boolean g_lcd_progress_glyphs_loaded = FALSE;
+
+/* Copy of the characters that should be on the screen */
+static uint8 g_lcd_frame_buffer[LCD_NUM_ROWS][LCD_NUM_COLS];
+
+/* One bit per cell that differs from the LCD DDRAM content */
+static uint16 g_lcd_dirty_cells[LCD_NUM_ROWS];
+
+/* Frame buffer cursor used by the display functions */
+static uint8 g_lcd_cursor_row = 0;
+static uint8 g_lcd_cursor_col = 0;
+
+/* DDRAM address the LCD will write next, the LCD increments it after every character */
+#define LCD_UNKNOWN_ADDRESS            0xFFu
+static uint8 g_lcd_ddram_address = LCD_UNKNOWN_ADDRESS;
+
+/*
+ * Bytes waiting to be written to the LCD, bit 8 holds the RS value.
+ * The application pushes and the tick ISR pops so the 8-bit indices need no locking
+ */
+static volatile uint16 g_lcd_queue[LCD_QUEUE_SIZE];
+static volatile uint8 g_lcd_queue_head = 0;
+static volatile uint8 g_lcd_queue_tail = 0;
+
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_DELAY)
+/* Ticks to wait before the next write after a clear or home command */
+#define LCD_HOME_EXECUTION_TICKS       ((LCD_HOME_EXECUTION_TIME_US / (1000u * TICK_PERIOD_MS)) + 1)
+static uint8 g_lcd_hold_ticks = 0;
+#endif
+
+/*******************************************************************************
+ *                      Functions Prototypes(Private)                          *
+ *******************************************************************************/
+
+/*
+ * Write one character in the frame buffer, cells outside the screen are dropped
+ */
+static void LCD_writeCell(uint8 row, uint8 col, uint8 data);
+
+/*
+ * Calculate the DDRAM address of a specified row and column
+ */
+static uint8 LCD_getAddress(uint8 row,uint8 col);
+
+/*
+ * Put one byte on the bus and strobe it in, no timing is waited
+ */
+static void LCD_writeBus(uint8 rs_value, uint8 data);
+
+/*
+ * Queue one byte to be written by the tick, only waits if the queue is full
+ */
+static void LCD_writeByte(uint8 rs_value, uint8 data);
+
+/*
+ * Write the queued bytes the LCD is ready for, called every tick
+ */
+static void LCD_tickHook(void);
+
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_BUSY_FLAG)
+/*
+ * Read the busy flag once, returns TRUE while the LCD executes the previous instruction
+ */
+static boolean LCD_isBusy(void);
+#endif
 
 /*******************************************************************************
  *                      Functions Definitions                                  *
@@ -29,9 +115,15 @@
  */
 void LCD_init(void)
 {
+	uint8 row, col;
 	/* Configure the direction for RS and E pins as output pins */
 	GPIO_setupPinDirection(LCD_RS_PORT_ID,LCD_RS_PIN_ID,PIN_OUTPUT);
 	GPIO_setupPinDirection(LCD_E_PORT_ID,LCD_E_PIN_ID,PIN_OUTPUT);
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW);
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_BUSY_FLAG)
+	GPIO_setupPinDirection(LCD_RW_PORT_ID,LCD_RW_PIN_ID,PIN_OUTPUT);
+	GPIO_writePin(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_LOW); /* Write mode RW=0 */
+#endif
 
 	_delay_ms(20);		/* LCD Power ON delay always > 15ms */
 
@@ -43,23 +135,43 @@ void LCD_init(void)
 	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
 
 	/* Send for 4 bit initialization of LCD  */
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
+	LCD_writeBus(LOGIC_LOW,LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
+	_delay_ms(LCD_INIT_COMMAND_TIME_MS);
+	LCD_writeBus(LOGIC_LOW,LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
+	_delay_ms(LCD_INIT_COMMAND_TIME_MS);
 
 	/* use 2-lines LCD + 4-bits Data Mode + 5*7 dot display Mode */
-	LCD_sendCommand(LCD_TWO_LINES_FOUR_BITS_MODE);
+	LCD_writeBus(LOGIC_LOW,LCD_TWO_LINES_FOUR_BITS_MODE);
+	_delay_ms(LCD_INIT_COMMAND_TIME_MS);
 
 #elif(LCD_DATA_BITS_MODE == 8)
 	/* Configure the data port as output port */
 	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_OUTPUT);
 
 	/* use 2-lines LCD + 8-bits Data Mode + 5*7 dot display Mode */
-	LCD_sendCommand(LCD_TWO_LINES_EIGHT_BITS_MODE);
+	LCD_writeBus(LOGIC_LOW,LCD_TWO_LINES_EIGHT_BITS_MODE);
+	_delay_ms(LCD_INIT_COMMAND_TIME_MS);
 
 #endif
 
 	LCD_sendCommand(LCD_CURSOR_OFF); /* cursor off */
 	LCD_sendCommand(LCD_CLEAR_COMMAND); /* clear LCD at the beginning */
+
+	/* LCD is blank now so the frame buffer matches it */
+	for(row = 0; row < LCD_NUM_ROWS; row++)
+	{
+		for(col = 0; col < LCD_NUM_COLS; col++)
+		{
+			g_lcd_frame_buffer[row][col] = ' ';
+		}
+		g_lcd_dirty_cells[row] = 0;
+	}
+	g_lcd_cursor_row = 0;
+	g_lcd_cursor_col = 0;
+	g_lcd_ddram_address = 0;
+
+	/* from now on the queued bytes are written by the tick */
+	Tick_addHook(LCD_tickHook);
 }
 
 /*
@@ -68,38 +180,8 @@ void LCD_init(void)
  */
 void LCD_sendCommand(uint8 command)
 {
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction Mode RS=0 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,7));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(command,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(command,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(command,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(command,3));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,command); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-#endif
+	LCD_writeByte(LOGIC_LOW,command); /* Instruction Mode RS=0 */
+	g_lcd_ddram_address = LCD_UNKNOWN_ADDRESS; /* the command may have moved the address counter */
 }
 
 /*
@@ -108,38 +190,11 @@ void LCD_sendCommand(uint8 command)
  */
 void LCD_displayCharacter(uint8 data)
 {
-	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_HIGH); /* Data Mode RS=1 */
-	_delay_ms(1); /* delay for processing Tas = 50ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-#if(LCD_DATA_BITS_MODE == 4)
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,5));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
-	_delay_ms(1); /* delay for processing Tpw - Tdws = 190ns */
-
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
-	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
-
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-
-#elif(LCD_DATA_BITS_MODE == 8)
-	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required command to the data bus D0 --> D7 */
-	_delay_ms(1); /* delay for processing Tdsw = 100ns */
-	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
-	_delay_ms(1); /* delay for processing Th = 13ns */
-#endif
+	LCD_writeCell(g_lcd_cursor_row, g_lcd_cursor_col, data);
+	if(g_lcd_cursor_col < LCD_NUM_COLS)
+	{
+		g_lcd_cursor_col++;
+	}
 }
 
 /*
@@ -163,32 +218,29 @@ void LCD_displayString(const char *Str)
 	*********************************************************/
 }
 
+/*
+ * Description :
+ * Display the required string stored in program memory (PSTR or PROGMEM) on the screen
+ */
+void LCD_displayString_P(const char *Str)
+{
+	uint8 character = pgm_read_byte(Str);
+	while(character != '\0')
+	{
+		LCD_displayCharacter(character);
+		Str++;
+		character = pgm_read_byte(Str);
+	}
+}
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
  */
 void LCD_moveCursor(uint8 row,uint8 col)
 {
-	uint8 lcd_memory_address;
-	
-	/* Calculate the required address in the LCD DDRAM */
-	switch(row)
-	{
-		case 0:
-			lcd_memory_address=col;
-				break;
-		case 1:
-			lcd_memory_address=col+0x40;
-				break;
-		case 2:
-			lcd_memory_address=col+0x10;
-				break;
-		case 3:
-			lcd_memory_address=col+0x50;
-				break;
-	}					
-	/* Move the LCD cursor to this specific address */
-	LCD_sendCommand(lcd_memory_address | LCD_SET_CURSOR_LOCATION);
+	g_lcd_cursor_row = row;
+	g_lcd_cursor_col = col;
 }
 
 /*
@@ -201,39 +253,402 @@ void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
 	LCD_displayString(Str); /* display the string */
 }
 
+/*
+ * Description :
+ * Display the required program memory string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str)
+{
+	LCD_moveCursor(row,col); /* go to to the required LCD position */
+	LCD_displayString_P(Str); /* display the string */
+}
+
 /*
  * Description :
  * Display the required decimal value on the screen
  */
 void LCD_intgerToString(int data)
 {
-   char buff[16]; /* String to hold the ascii result */
-   itoa(data,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-   LCD_displayString(buff); /* Display the string */
+	LCD_displayFixedPoint(data, 0, 0, LCD_FORMAT_SPACE_PAD);
+}
+
+/*
+ * Description :
+ * Display a decimal value right aligned in a field of the given width,
+ * a width smaller than the number of characters is ignored
+ */
+void LCD_displayInteger(sint32 value, uint8 width, uint8 format_flags)
+{
+	LCD_displayFixedPoint(value, 0, width, format_flags);
 }
 
+/*
+ * Description :
+ * Display a fixed-point value holding the given number of fraction digits,
+ * e.g. value 1234 with 2 fraction digits is displayed as 12.34
+ */
+void LCD_displayFixedPoint(sint32 value, uint8 fraction_digits, uint8 width, uint8 format_flags)
+{
+	uint32 magnitude, remaining;
+	uint8 num_of_digits = 1, length, col;
+	boolean is_negative = (value < 0);
+
+	magnitude = is_negative ? (0UL - (uint32)value) : (uint32)value;
+	for(remaining = magnitude / 10; remaining != 0; remaining /= 10)
+	{
+		num_of_digits++;
+	}
+	if(num_of_digits <= fraction_digits)
+	{
+		num_of_digits = fraction_digits + 1; /* leading zero before the point */
+	}
+
+	length = num_of_digits + ((fraction_digits != 0) ? 1 : 0) + (is_negative ? 1 : 0);
+	if(width < length)
+	{
+		width = length;
+	}
+
+	/*
+	 * Digits are written from the right end of the field straight into
+	 * the frame buffer so no string is built in between
+	 */
+	col = g_lcd_cursor_col + width;
+	while(num_of_digits != 0)
+	{
+		col--;
+		if((fraction_digits != 0) && (col == (uint8)(g_lcd_cursor_col + width - 1 - fraction_digits)))
+		{
+			LCD_writeCell(g_lcd_cursor_row, col, '.');
+			continue;
+		}
+		LCD_writeCell(g_lcd_cursor_row, col, (uint8)('0' + (magnitude % 10)));
+		magnitude /= 10;
+		num_of_digits--;
+	}
+
+	/* Padding and sign fill the rest of the field */
+	if(format_flags & LCD_FORMAT_ZERO_PAD)
+	{
+		while(col > (uint8)(g_lcd_cursor_col + (is_negative ? 1 : 0)))
+		{
+			LCD_writeCell(g_lcd_cursor_row, --col, '0');
+		}
+		if(is_negative)
+		{
+			LCD_writeCell(g_lcd_cursor_row, --col, '-');
+		}
+	}
+	else
+	{
+		if(is_negative)
+		{
+			LCD_writeCell(g_lcd_cursor_row, --col, '-');
+		}
+		while(col > g_lcd_cursor_col)
+		{
+			LCD_writeCell(g_lcd_cursor_row, --col, ' ');
+		}
+	}
+
+	g_lcd_cursor_col += width;
+}
+
+#if (LCD_FLOAT_SUPPORT == TRUE)
 /*
  * Description :
  * Display the required decimal float value on the screen
  */
 void LCD_floatToString(float32 data)
 {
-   char buff[16]; /* String to hold the ascii result */
-   uint32 intgerPart = (uint32)(data);
-   uint32 fractionPart = (uint32)((data - (uint32)data)*10);
-   itoa(intgerPart,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-   LCD_displayString(buff); /* Display the string */
-   LCD_displayCharacter('.');
-   itoa(fractionPart,buff,10); /* Use itoa C function to convert the data to its corresponding ASCII value, 10 for decimal */
-   LCD_displayString(buff); /* Display the string */
+	LCD_displayFixedPoint((sint32)(data * 10), 1, 0, LCD_FORMAT_SPACE_PAD);
 }
+#endif
 
+/*
+ * Description :
+ * Load custom 5x8 glyphs stored in program memory into the CGRAM,
+ * starting at the given character code (0 to 7), 8 bytes per glyph
+ */
+void LCD_createCustomCharacters_P(uint8 first_code, const uint8 *glyphs_Ptr, uint8 num_of_glyphs)
+{
+	uint8 byte_index;
+	if((first_code + num_of_glyphs) > LCD_NUM_OF_CUSTOM_CHARS)
+	{
+		num_of_glyphs = LCD_NUM_OF_CUSTOM_CHARS - first_code;
+	}
+	LCD_writeByte(LOGIC_LOW,LCD_SET_CGRAM_ADDRESS | (uint8)(first_code << 3));
+	for(byte_index = 0; byte_index < (uint8)(num_of_glyphs * LCD_GLYPH_HEIGHT); byte_index++)
+	{
+		LCD_writeByte(LOGIC_HIGH,pgm_read_byte(glyphs_Ptr + byte_index));
+	}
+	/* the address counter points to the CGRAM now, next flush has to move the cursor */
+	g_lcd_ddram_address = LCD_UNKNOWN_ADDRESS;
+}
 
 /*
  * Description :
- * Send the clear screen command
+ * Load the progress bar glyphs and place an empty bar of the given width
+ */
+void LCD_progressBarInit(uint8 row, uint8 col, uint8 width)
+{
+	if(g_lcd_progress_glyphs_loaded == FALSE)
+	{
+		LCD_createCustomCharacters_P(LCD_PROGRESS_FIRST_GLYPH_CODE, g_lcd_progress_glyphs, LCD_PROGRESS_STEPS_PER_CELL);
+		g_lcd_progress_glyphs_loaded = TRUE;
+	}
+	g_lcd_progress_row = row;
+	g_lcd_progress_col = col;
+	g_lcd_progress_width = width;
+	LCD_progressBarUpdate(0, 1);
+}
+
+/*
+ * Description :
+ * Fill the progress bar in proportion to value/max_value,
+ * only the cells whose fill changed are written to the screen
+ */
+void LCD_progressBarUpdate(uint16 value, uint16 max_value)
+{
+	uint8 cell;
+	uint16 filled_steps, cell_steps;
+	if(value > max_value)
+	{
+		value = max_value;
+	}
+	filled_steps = (uint16)(((uint32)value * g_lcd_progress_width * LCD_PROGRESS_STEPS_PER_CELL) / max_value);
+
+	LCD_moveCursor(g_lcd_progress_row, g_lcd_progress_col);
+	for(cell = 0; cell < g_lcd_progress_width; cell++)
+	{
+		/* the frame buffer drops the cells that didn't change */
+		cell_steps = (filled_steps > LCD_PROGRESS_STEPS_PER_CELL) ? LCD_PROGRESS_STEPS_PER_CELL : filled_steps;
+		filled_steps -= cell_steps;
+		if(cell_steps == 0)
+		{
+			LCD_displayCharacter(' ');
+		}
+		else
+		{
+			LCD_displayCharacter((uint8)(LCD_PROGRESS_FIRST_GLYPH_CODE + cell_steps - 1));
+		}
+	}
+}
+
+/*
+ * Description :
+ * Clear the frame buffer and move the cursor to the first cell
  */
 void LCD_clearScreen(void)
 {
-	LCD_sendCommand(LCD_CLEAR_COMMAND); /* Send clear display command */
+	/*
+	 * The slow clear command is not sent, blank cells are only
+	 * written if they are not already blank on the screen
+	 */
+	uint8 row, col;
+	for(row = 0; row < LCD_NUM_ROWS; row++)
+	{
+		for(col = 0; col < LCD_NUM_COLS; col++)
+		{
+			if(g_lcd_frame_buffer[row][col] != ' ')
+			{
+				g_lcd_frame_buffer[row][col] = ' ';
+				g_lcd_dirty_cells[row] |= (uint16)(1u << col);
+			}
+		}
+	}
+	g_lcd_cursor_row = 0;
+	g_lcd_cursor_col = 0;
+}
+
+/*
+ * Description :
+ * Check if all the queued bytes were written to the LCD
+ */
+boolean LCD_isIdle(void)
+{
+	return (g_lcd_queue_head == g_lcd_queue_tail);
+}
+
+/*
+ * Description :
+ * Send the changed cells of the frame buffer to the LCD
+ */
+void LCD_flush(void)
+{
+	uint8 row, col, address;
+	uint16 dirty_cells;
+	for(row = 0; row < LCD_NUM_ROWS; row++)
+	{
+		dirty_cells = g_lcd_dirty_cells[row];
+		for(col = 0; (col < LCD_NUM_COLS) && (dirty_cells != 0); col++, dirty_cells >>= 1)
+		{
+			/*
+			 * A clean cell between two dirty ones costs the same to rewrite as
+			 * a cursor move, so it is rewritten and the run continues
+			 */
+			if(((dirty_cells & 0x01) == 0) &&
+					(((dirty_cells & 0x02) == 0) || (g_lcd_ddram_address != LCD_getAddress(row,col))))
+			{
+				continue;
+			}
+			address = LCD_getAddress(row,col);
+			if(g_lcd_ddram_address != address)
+			{
+				LCD_writeByte(LOGIC_LOW,address | LCD_SET_CURSOR_LOCATION);
+			}
+			LCD_writeByte(LOGIC_HIGH,g_lcd_frame_buffer[row][col]);
+			g_lcd_ddram_address = address + 1;
+		}
+		g_lcd_dirty_cells[row] = 0;
+	}
+}
+
+/*******************************************************************************
+ *                      Functions Definitions(Private)                         *
+ *******************************************************************************/
+
+static void LCD_writeBus(uint8 rs_value, uint8 data)
+{
+	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,rs_value); /* Tas = 40ns is covered by the call itself */
+
+#if(LCD_DATA_BITS_MODE == 4)
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,4));
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,5));
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,6));
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,7));
+
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	_delay_us(LCD_ENABLE_PULSE_US); /* Tpw = 230ns */
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0, data is latched */
+	_delay_us(LCD_ENABLE_PULSE_US); /* Th = 10ns and E cycle time = 500ns */
+
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,GET_BIT(data,0));
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,GET_BIT(data,1));
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,GET_BIT(data,2));
+	GPIO_writePin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,GET_BIT(data,3));
+
+#elif(LCD_DATA_BITS_MODE == 8)
+	GPIO_writePort(LCD_DATA_PORT_ID,data); /* out the required data to the data bus D0 --> D7 */
+#endif
+
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	_delay_us(LCD_ENABLE_PULSE_US); /* Tpw = 230ns */
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0, data is latched */
+	_delay_us(LCD_ENABLE_PULSE_US); /* Th = 10ns and E cycle time = 500ns */
+}
+
+static void LCD_writeByte(uint8 rs_value, uint8 data)
+{
+	uint8 head = g_lcd_queue_head;
+	uint8 next_head = (uint8)((head + 1) % LCD_QUEUE_SIZE);
+	while(next_head == g_lcd_queue_tail){} /* queue is full, wait for the tick to drain it */
+	g_lcd_queue[head] = ((uint16)rs_value << 8) | data;
+	g_lcd_queue_head = next_head;
+}
+
+static void LCD_tickHook(void)
+{
+	uint8 num_of_bytes = 0, tail, rs_value, data;
+
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_DELAY)
+	if(g_lcd_hold_ticks != 0)
+	{
+		g_lcd_hold_ticks--;
+		return;
+	}
+#endif
+
+	while((num_of_bytes < LCD_BYTES_PER_TICK) && (g_lcd_queue_tail != g_lcd_queue_head))
+	{
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_BUSY_FLAG)
+		if(LCD_isBusy() == TRUE)
+		{
+			return; /* try again next tick */
+		}
+#endif
+		tail = g_lcd_queue_tail;
+		rs_value = (uint8)(g_lcd_queue[tail] >> 8);
+		data = (uint8)g_lcd_queue[tail];
+		LCD_writeBus(rs_value,data);
+		g_lcd_queue_tail = (uint8)((tail + 1) % LCD_QUEUE_SIZE);
+		num_of_bytes++;
+
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_DELAY)
+		/* clear display (0x01) and return home (0x02, 0x03) are the only slow instructions */
+		if((rs_value == LOGIC_LOW) && (data <= LCD_GO_TO_HOME + 1))
+		{
+			g_lcd_hold_ticks = LCD_HOME_EXECUTION_TICKS;
+			return;
+		}
+		_delay_us(LCD_EXECUTION_TIME_US);
+#endif
+	}
+}
+
+#if (LCD_TIMING_MODE_SELECT == LCD_TIMING_BUSY_FLAG)
+static boolean LCD_isBusy(void)
+{
+	uint8 busy_flag;
+
+	/* The LCD drives the data bus while it is read */
+#if(LCD_DATA_BITS_MODE == 4)
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_INPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_INPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_INPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_INPUT);
+#elif(LCD_DATA_BITS_MODE == 8)
+	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_INPUT);
+#endif
+	GPIO_writePin(LCD_RS_PORT_ID,LCD_RS_PIN_ID,LOGIC_LOW); /* Instruction register RS=0 */
+	GPIO_writePin(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_HIGH); /* Read mode RW=1 */
+
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH); /* Enable LCD E=1 */
+	_delay_us(LCD_ENABLE_PULSE_US); /* Tddr = 360ns */
+#if(LCD_DATA_BITS_MODE == 4)
+	GPIO_readPin(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,&busy_flag);
+#elif(LCD_DATA_BITS_MODE == 8)
+	GPIO_readPin(LCD_DATA_PORT_ID,PIN7_ID,&busy_flag);
+#endif
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW); /* Disable LCD E=0 */
+	_delay_us(LCD_ENABLE_PULSE_US);
+#if(LCD_DATA_BITS_MODE == 4)
+	/* second nibble holds the low address counter bits, it is read and ignored */
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_HIGH);
+	_delay_us(LCD_ENABLE_PULSE_US);
+	GPIO_writePin(LCD_E_PORT_ID,LCD_E_PIN_ID,LOGIC_LOW);
+	_delay_us(LCD_ENABLE_PULSE_US);
+#endif
+
+	GPIO_writePin(LCD_RW_PORT_ID,LCD_RW_PIN_ID,LOGIC_LOW); /* Write mode RW=0 */
+#if(LCD_DATA_BITS_MODE == 4)
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB4_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB5_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB6_PIN_ID,PIN_OUTPUT);
+	GPIO_setupPinDirection(LCD_DATA_PORT_ID,LCD_DB7_PIN_ID,PIN_OUTPUT);
+#elif(LCD_DATA_BITS_MODE == 8)
+	GPIO_setupPortDirection(LCD_DATA_PORT_ID,PORT_OUTPUT);
+#endif
+
+	return (busy_flag == LOGIC_HIGH);
+}
+#endif
+
+static void LCD_writeCell(uint8 row, uint8 col, uint8 data)
+{
+	if((row >= LCD_NUM_ROWS) || (col >= LCD_NUM_COLS))
+	{
+		return;
+	}
+	if(g_lcd_frame_buffer[row][col] != data)
+	{
+		g_lcd_frame_buffer[row][col] = data;
+		g_lcd_dirty_cells[row] |= (uint16)(1u << col);
+	}
+}
+
+static uint8 LCD_getAddress(uint8 row,uint8 col)
+{
+	/* Calculate the required address in the LCD DDRAM */
+	return (uint8)(pgm_read_byte(&g_lcd_row_address[row & 0x03]) + col);
 }
@@ -28,6 +28,24 @@
 
 #endif
 
+/* LCD size, the frame buffer keeps a copy of every visible character */
+#define LCD_NUM_ROWS                   2
+#define LCD_NUM_COLS                   16
+
+#if (LCD_NUM_COLS > 16)
+#error "Dirty bitmap of a row is 16 bits wide"
+#endif
+
+/*
+ * LCD_floatToString() needs the soft-float library, it is only
+ * compiled when an application needs it
+ */
+#define LCD_FLOAT_SUPPORT              FALSE
+
+/* Number formatting flags */
+#define LCD_FORMAT_SPACE_PAD           0x00u
+#define LCD_FORMAT_ZERO_PAD            0x01u
+
 /* LCD HW Ports and Pins Ids */
 #define LCD_RS_PORT_ID                 PORTC_ID
 #define LCD_RS_PIN_ID                  PIN0_ID
@@ -35,6 +53,10 @@
 #define LCD_E_PORT_ID                  PORTC_ID
 #define LCD_E_PIN_ID                   PIN1_ID
 
+/* RW is only driven when the busy flag is polled, otherwise it should be tied to ground */
+#define LCD_RW_PORT_ID                 PORTC_ID
+#define LCD_RW_PIN_ID                  PIN2_ID
+
 #define LCD_DATA_PORT_ID               PORTA_ID
 
 #if (LCD_DATA_BITS_MODE == 4)
@@ -46,6 +68,31 @@
 
 #endif
 
+/*
+ * LCD timing configuration:
+ * LCD_TIMING_BUSY_FLAG : RW is wired so the busy flag is read back before each write
+ * LCD_TIMING_DELAY     : RW is tied to ground so the datasheet execution time is waited after each write
+ */
+#define LCD_TIMING_DELAY               0u
+#define LCD_TIMING_BUSY_FLAG           1u
+
+#define LCD_TIMING_MODE_SELECT         LCD_TIMING_DELAY
+
+/* HD44780 execution times in microseconds (datasheet values at 270 kHz plus margin) */
+#define LCD_EXECUTION_TIME_US          40     /* 37 us for most instructions and data writes */
+#define LCD_HOME_EXECUTION_TIME_US     1600   /* 1.52 ms for clear display and return home */
+#define LCD_INIT_COMMAND_TIME_MS       5      /* busy flag can't be read before the interface is set */
+
+/* E pulse width and hold time, Tpw = 230 ns and Tc = 500 ns so 1 us covers both */
+#define LCD_ENABLE_PULSE_US            1
+
+/*
+ * Writes are queued and drained from the system tick, a full screen redraw
+ * (32 characters + 2 cursor moves) fits in the queue without waiting
+ */
+#define LCD_QUEUE_SIZE                 64u
+#define LCD_BYTES_PER_TICK             4u
+
 /* LCD Commands */
 #define LCD_CLEAR_COMMAND                    0x01
 #define LCD_GO_TO_HOME                       0x02
@@ -56,6 +103,18 @@
 #define LCD_CURSOR_OFF                       0x0C
 #define LCD_CURSOR_ON                        0x0E
 #define LCD_SET_CURSOR_LOCATION              0x80
+#define LCD_SET_CGRAM_ADDRESS                0x40
+
+/* Custom characters, each glyph is 8 rows of 5 pixels (bit 4 is the leftmost pixel) */
+#define LCD_NUM_OF_CUSTOM_CHARS              8
+#define LCD_GLYPH_HEIGHT                     8
+
+/*
+ * Progress bar widget, character codes 1 to 5 hold 1 to 5 filled pixel columns
+ * (code 0 is avoided so the glyphs can't terminate a string)
+ */
+#define LCD_PROGRESS_FIRST_GLYPH_CODE        1
+#define LCD_PROGRESS_STEPS_PER_CELL          5
 
 /*******************************************************************************
  *                      Functions Prototypes                                   *
@@ -66,18 +125,21 @@
  * Initialize the LCD:
  * 1. Setup the LCD pins directions by use the GPIO driver.
  * 2. Setup the LCD Data Mode 4-bits or 8-bits.
+ * 3. Attach the output queue to the system tick.
  */
 void LCD_init(void);
 
 /*
  * Description :
- * Send the required command to the screen
+ * Queue the required command to the screen,
+ * commands that change the display content bypass the frame buffer
  */
 void LCD_sendCommand(uint8 command);
 
 /*
  * Description :
- * Display the required character on the screen
+ * Display the required character on the screen,
+ * all display functions only update the frame buffer until LCD_flush() is called
  */
 void LCD_displayCharacter(uint8 data);
 
@@ -87,6 +149,12 @@ void LCD_displayCharacter(uint8 data);
  */
 void LCD_displayString(const char *Str);
 
+/*
+ * Description :
+ * Display the required string stored in program memory (PSTR or PROGMEM) on the screen
+ */
+void LCD_displayString_P(const char *Str);
+
 /*
  * Description :
  * Move the cursor to a specified row and column index on the screen
@@ -99,22 +167,76 @@ void LCD_moveCursor(uint8 row,uint8 col);
  */
 void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str);
 
+/*
+ * Description :
+ * Display the required program memory string in a specified row and column index on the screen
+ */
+void LCD_displayStringRowColumn_P(uint8 row,uint8 col,const char *Str);
+
 /*
  * Description :
  * Display the required decimal value on the screen
  */
 void LCD_intgerToString(int data);
 
+/*
+ * Description :
+ * Display a decimal value right aligned in a field of the given width,
+ * a width smaller than the number of characters is ignored
+ */
+void LCD_displayInteger(sint32 value, uint8 width, uint8 format_flags);
+
+/*
+ * Description :
+ * Display a fixed-point value holding the given number of fraction digits,
+ * e.g. value 1234 with 2 fraction digits is displayed as 12.34
+ */
+void LCD_displayFixedPoint(sint32 value, uint8 fraction_digits, uint8 width, uint8 format_flags);
+
+#if (LCD_FLOAT_SUPPORT == TRUE)
 /*
  * Description :
  * Display the required decimal float value on the screen
  */
 void LCD_floatToString(float32 data);
+#endif
 
 /*
  * Description :
- * Send the clear screen command
+ * Load custom 5x8 glyphs stored in program memory into the CGRAM,
+ * starting at the given character code (0 to 7), 8 bytes per glyph
+ */
+void LCD_createCustomCharacters_P(uint8 first_code, const uint8 *glyphs_Ptr, uint8 num_of_glyphs);
+
+/*
+ * Description :
+ * Load the progress bar glyphs and place an empty bar of the given width
+ */
+void LCD_progressBarInit(uint8 row, uint8 col, uint8 width);
+
+/*
+ * Description :
+ * Fill the progress bar in proportion to value/max_value,
+ * only the cells whose fill changed are written to the screen
+ */
+void LCD_progressBarUpdate(uint16 value, uint16 max_value);
+
+/*
+ * Description :
+ * Clear the frame buffer and move the cursor to the first cell
  */
 void LCD_clearScreen(void);
 
+/*
+ * Description :
+ * Send the changed cells of the frame buffer to the LCD
+ */
+void LCD_flush(void);
+
+/*
+ * Description :
+ * Check if all the queued bytes were written to the LCD
+ */
+boolean LCD_isIdle(void);
+
 #endif /* LCD_H_ */
@@ -0,0 +1,1124 @@
+/*
+ *  File: Source file for ECU link RPC layer
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "link.h"
+#include "uart.h"
+#include "tick.h"
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+/* a node only hears the master when polled, it counts a missed poll round as a missed heartbeat */
+#define LINK_NODE_PERIOD_MS		((LINK_BUS_POLL_ROUND_MS > LINK_HEARTBEAT_PERIOD_MS) ? \
+		LINK_BUS_POLL_ROUND_MS : LINK_HEARTBEAT_PERIOD_MS)
+#else
+#define LINK_NODE_PERIOD_MS		LINK_HEARTBEAT_PERIOD_MS
+#endif
+
+typedef enum
+{
+	LINK_RX_HUNT,
+	LINK_RX_SOURCE,
+	LINK_RX_KIND,
+	LINK_RX_ID,
+	LINK_RX_TYPE,
+	LINK_RX_LENGTH,
+	LINK_RX_PAYLOAD,
+	LINK_RX_CRC
+}Link_RxStateType;
+
+typedef enum
+{
+	LINK_ENTRY_FREE,
+	LINK_ENTRY_WAITING,
+	LINK_ENTRY_DONE,
+	LINK_ENTRY_FAILED
+}Link_PendingStateType;
+
+typedef enum
+{
+	LINK_CACHE_FREE,
+	LINK_CACHE_IN_PROGRESS,		/* delivered to the application, not answered yet */
+	LINK_CACHE_REPLY_WAITING,	/* master: answered while another node held the bus */
+	LINK_CACHE_REPLIED
+}Link_CacheStateType;
+
+typedef struct
+{
+	uint8 state;
+	uint8 retries_left;
+	boolean is_sent;			/* a node holds its frames until the master gives it the bus */
+	boolean is_tracked;			/* an event whose result is kept for Link_getResult() */
+	Tick_Type sent_tick;
+	Link_MessageType message;	/* the request, replaced by the reply once it arrives */
+}Link_PendingType;
+
+typedef struct
+{
+	uint8 state;
+	Link_MessageType reply;		/* id and address are those of the request answered */
+}Link_CacheType;
+
+static Link_PendingType g_link_pending[LINK_MAX_PENDING];
+static Link_CacheType g_link_cache[LINK_REPLY_CACHE_SIZE];
+static uint8 g_link_cache_next = 0;
+static Link_MessageType g_link_rx_queue[LINK_RX_QUEUE_SIZE];
+static uint8 g_link_rx_queue_head = 0;
+static uint8 g_link_rx_queue_count = 0;
+static uint8 g_link_next_id = LINK_NO_ID;
+
+static Link_RxStateType g_link_rx_state = LINK_RX_HUNT;
+static Link_MessageType g_link_rx_frame;
+static uint8 g_link_rx_index = 0;
+static uint8 g_link_rx_crc = 0;
+static Tick_Type g_link_rx_last_tick = 0;
+
+static boolean g_link_is_up = FALSE;
+static boolean g_link_is_peer_heard = FALSE;	/* since the last heartbeat period */
+static boolean g_link_is_resync_pending = FALSE;
+static uint8 g_link_missed_heartbeats = 0;
+static uint8 g_link_heartbeat_id = LINK_NO_ID;
+static boolean g_link_is_heartbeat_acked = TRUE;
+static Tick_Type g_link_heartbeat_tick = 0;
+static Tick_Type g_link_period_tick = 0;
+static uint16 g_link_round_trip_ms = LINK_NO_ROUND_TRIP;
+/* kept through a reset, counts the boots from a random power-on value */
+static uint8 g_link_boot_id __attribute__((section(".noinit")));
+/* master: boot id of each node, node: of the master in the first entry */
+static uint8 g_link_peer_boot_ids[LINK_MAX_NODES];
+
+static uint8 g_link_own_address = LINK_MASTER_ADDRESS;
+/* master: node of the session, the requests and events go to it, node: LINK_MASTER_ADDRESS */
+static uint8 g_link_node_address = LINK_FIRST_NODE_ADDRESS;
+static Link_NodeStatusType g_link_nodes[LINK_MAX_NODES];
+/* node: returned in the heartbeat acknowledges */
+static uint8 g_link_status[LINK_NODE_STATUS_SIZE];
+static uint8 g_link_status_length = 0;
+/* node: last broadcast of the master */
+static Link_MessageType g_link_broadcast_rx;
+static boolean g_link_is_broadcast_received = FALSE;
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+/* master: node addressed last, the frames received come from it */
+static uint8 g_link_bus_address = LINK_FIRST_NODE_ADDRESS;
+/* master: the node addressed last has not answered yet */
+static boolean g_link_is_bus_held = FALSE;
+static Tick_Type g_link_bus_tick = 0;
+static Tick_Type g_link_slot_tick = 0;
+static uint8 g_link_poll_address = LINK_FIRST_NODE_ADDRESS;
+static boolean g_link_is_session_slot = TRUE;
+/* master: broadcast waiting for the bus */
+static Link_MessageType g_link_broadcast_tx;
+static boolean g_link_is_broadcast_waiting = FALSE;
+/* node: request whose reply may still be sent before the master takes the bus back */
+static uint8 g_link_reply_window_id = LINK_NO_ID;
+static Tick_Type g_link_reply_window_tick = 0;
+#endif
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * CRC-8 with polynomial 0x07
+ */
+static uint8 Link_crcUpdate(uint8 crc, uint8 data)
+{
+	uint8 bit_index;
+	crc ^= data;
+	for(bit_index = 0; bit_index < 8; bit_index++)
+	{
+		crc = (crc & 0x80) ? (uint8)((crc << 1) ^ 0x07) : (uint8)(crc << 1);
+	}
+	return crc;
+}
+
+static void Link_sendFrame(const Link_MessageType* message_Ptr)
+{
+	uint8 crc = 0, byte_index;
+	UART_sendByte(LINK_START_OF_FRAME);
+	UART_sendByte(g_link_own_address);
+	crc = Link_crcUpdate(crc, g_link_own_address);
+	UART_sendByte(message_Ptr->kind);
+	crc = Link_crcUpdate(crc, message_Ptr->kind);
+	UART_sendByte(message_Ptr->id);
+	crc = Link_crcUpdate(crc, message_Ptr->id);
+	UART_sendByte(message_Ptr->type);
+	crc = Link_crcUpdate(crc, message_Ptr->type);
+	UART_sendByte(message_Ptr->length);
+	crc = Link_crcUpdate(crc, message_Ptr->length);
+	for(byte_index = 0; byte_index < message_Ptr->length; byte_index++)
+	{
+		UART_sendByte(message_Ptr->payload[byte_index]);
+		crc = Link_crcUpdate(crc, message_Ptr->payload[byte_index]);
+	}
+	UART_sendByte(crc);
+}
+
+/*
+ * Description:
+ * Sends a frame to a node, on the bus the master addresses the node first
+ * and holds the bus until the node answers a frame that expects an answer
+ */
+static void Link_transmit(const Link_MessageType* message_Ptr, uint8 address)
+{
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if(g_link_own_address == LINK_MASTER_ADDRESS)
+	{
+		UART_sendAddress(address);
+		g_link_bus_address = address;
+		g_link_is_bus_held = (message_Ptr->kind != LINK_REPLY) && (message_Ptr->kind != LINK_HEARTBEAT_ACK) &&
+				(address != LINK_BROADCAST_ADDRESS);
+	}
+	Link_sendFrame(message_Ptr);
+	g_link_bus_tick = Tick_getTicks();
+#else
+	Link_sendFrame(message_Ptr);
+#endif
+}
+
+/*
+ * Description:
+ * Returns TRUE if this ECU may start a frame of its own, a node on the bus
+ * only answers the master
+ */
+static boolean Link_isBusFree(void)
+{
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	return (g_link_own_address == LINK_MASTER_ADDRESS) && (g_link_is_bus_held == FALSE);
+#else
+	return TRUE;
+#endif
+}
+
+static void Link_fillMessage(Link_MessageType* message_Ptr, uint8 kind, uint8 id, uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	uint8 byte_index;
+	if(length > LINK_MAX_PAYLOAD_SIZE)
+	{
+		length = LINK_MAX_PAYLOAD_SIZE;
+	}
+	message_Ptr->kind = kind;
+	message_Ptr->id = id;
+	message_Ptr->type = type;
+	message_Ptr->length = length;
+	for(byte_index = 0; byte_index < length; byte_index++)
+	{
+		message_Ptr->payload[byte_index] = payload_Ptr[byte_index];
+	}
+}
+
+static boolean Link_isNodeAddress(uint8 address)
+{
+	return (address >= LINK_FIRST_NODE_ADDRESS) && (address < (LINK_FIRST_NODE_ADDRESS + LINK_MAX_NODES));
+}
+
+/*
+ * Description:
+ * Every node numbers its own requests so the master looks them up by both
+ */
+static Link_CacheType* Link_findCache(uint8 address, uint8 id)
+{
+	uint8 cache_index;
+	for(cache_index = 0; cache_index < LINK_REPLY_CACHE_SIZE; cache_index++)
+	{
+		if((g_link_cache[cache_index].state != LINK_CACHE_FREE) && (g_link_cache[cache_index].reply.id == id) &&
+				(g_link_cache[cache_index].reply.address == address))
+		{
+			return &g_link_cache[cache_index];
+		}
+	}
+	return NULL_PTR;
+}
+
+/*
+ * Description:
+ * Sends the first request or event due for its first transmission or for
+ * a retransmission, returns FALSE if none is due
+ */
+static boolean Link_sendDuePending(void)
+{
+	uint8 pending_index;
+	Link_PendingType* pending_Ptr;
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		pending_Ptr = &g_link_pending[pending_index];
+		if((pending_Ptr->state == LINK_ENTRY_WAITING) && ((pending_Ptr->is_sent == FALSE) ||
+				((Tick_elapsedSince(pending_Ptr->sent_tick) >= LINK_REPLY_TIMEOUT_MS) && (pending_Ptr->retries_left > 0))))
+		{
+			/* same id so the peer recognizes the retransmission */
+			if(pending_Ptr->is_sent == TRUE)
+			{
+				pending_Ptr->retries_left--;
+			}
+			pending_Ptr->is_sent = TRUE;
+			pending_Ptr->sent_tick = Tick_getTicks();
+			Link_transmit(&pending_Ptr->message, pending_Ptr->message.address);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * Description:
+ * The heartbeat type byte tells whether the sender hears the node, only the
+ * heartbeats of the session are timed
+ */
+static void Link_sendHeartbeat(uint8 address)
+{
+	Link_MessageType heartbeat;
+	if(address == g_link_node_address)
+	{
+		g_link_heartbeat_id++;
+		Link_fillMessage(&heartbeat, LINK_HEARTBEAT, g_link_heartbeat_id, g_link_is_up, &g_link_boot_id, 1);
+		g_link_is_heartbeat_acked = FALSE;
+		g_link_heartbeat_tick = Tick_getTicks();
+	}
+	else
+	{
+		/* a polled node is not in session, it only resyncs if it was lost */
+		Link_fillMessage(&heartbeat, LINK_HEARTBEAT, LINK_NO_ID, g_link_nodes[address - LINK_FIRST_NODE_ADDRESS].is_up,
+				&g_link_boot_id, 1);
+	}
+	Link_transmit(&heartbeat, address);
+}
+
+/*
+ * Description:
+ * Master only, a node is reported down after the same number of missed
+ * answers as the link
+ */
+static void Link_missNode(uint8 address)
+{
+	Link_NodeStatusType* node_Ptr = &g_link_nodes[address - LINK_FIRST_NODE_ADDRESS];
+	if(node_Ptr->missed_polls < LINK_HEARTBEAT_MISS_THRESHOLD)
+	{
+		node_Ptr->missed_polls++;
+	}
+	if(node_Ptr->missed_polls >= LINK_HEARTBEAT_MISS_THRESHOLD)
+	{
+		node_Ptr->is_up = FALSE;
+	}
+}
+
+/*
+ * Description:
+ * Drops the received messages and the cached replies of a node, the master
+ * keeps those of the other nodes
+ */
+static void Link_flushSession(uint8 address)
+{
+	uint8 entry_index, queue_count = g_link_rx_queue_count;
+	Link_MessageType* message_Ptr;
+	for(entry_index = 0; entry_index < LINK_REPLY_CACHE_SIZE; entry_index++)
+	{
+		if(g_link_cache[entry_index].reply.address == address)
+		{
+			g_link_cache[entry_index].state = LINK_CACHE_FREE;
+		}
+	}
+	/* the queue is compacted in place so the messages kept stay in order */
+	g_link_rx_queue_count = 0;
+	for(entry_index = 0; entry_index < queue_count; entry_index++)
+	{
+		message_Ptr = &g_link_rx_queue[(g_link_rx_queue_head + entry_index) % LINK_RX_QUEUE_SIZE];
+		if(message_Ptr->address != address)
+		{
+			g_link_rx_queue[(g_link_rx_queue_head + g_link_rx_queue_count) % LINK_RX_QUEUE_SIZE] = *message_Ptr;
+			g_link_rx_queue_count++;
+		}
+	}
+	g_link_is_broadcast_received = FALSE;
+}
+
+/*
+ * Description:
+ * Ends the requests and events waiting for a node, its requests fail and
+ * the tracked events too so their owners find out
+ */
+static void Link_dropPending(uint8 address)
+{
+	uint8 pending_index;
+	Link_PendingType* pending_Ptr;
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		pending_Ptr = &g_link_pending[pending_index];
+		if((pending_Ptr->state == LINK_ENTRY_WAITING) && (pending_Ptr->message.address == address))
+		{
+			pending_Ptr->state = ((pending_Ptr->message.kind == LINK_EVENT) && (pending_Ptr->is_tracked == FALSE)) ?
+					LINK_ENTRY_FREE : LINK_ENTRY_FAILED;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Master only, keeps the state of the node a frame was received from. A
+ * node out of session that restarted or lost the master has forgotten the
+ * ids and the events of before, they are dropped as on a new session
+ */
+static void Link_updateNode(uint8 address, const Link_MessageType* frame_Ptr, boolean is_restarted)
+{
+	Link_NodeStatusType* node_Ptr = &g_link_nodes[address - LINK_FIRST_NODE_ADDRESS];
+	uint8 byte_index;
+	if((address != g_link_node_address) && ((node_Ptr->is_up == FALSE) || (is_restarted == TRUE) ||
+			(((frame_Ptr->kind == LINK_HEARTBEAT) || (frame_Ptr->kind == LINK_HEARTBEAT_ACK)) && (frame_Ptr->type == FALSE))))
+	{
+		Link_flushSession(address);
+		Link_dropPending(address);
+	}
+	node_Ptr->is_up = TRUE;
+	node_Ptr->missed_polls = 0;
+	if(frame_Ptr->kind == LINK_HEARTBEAT_ACK)
+	{
+		for(byte_index = 0; ((byte_index + LINK_BOOT_ID_INDEX + 1) < frame_Ptr->length) &&
+				(byte_index < LINK_NODE_STATUS_SIZE); byte_index++)
+		{
+			node_Ptr->status[byte_index] = frame_Ptr->payload[byte_index + LINK_BOOT_ID_INDEX + 1];
+		}
+	}
+}
+
+/*
+ * Description:
+ * Starts a new session with the peer, its ids restart so the replies cached
+ * for the old session could answer new requests and are dropped. The events
+ * not delivered yet describe the old session too and the requests not
+ * answered yet fail, the peer state they relied on is gone
+ */
+static void Link_startSession(void)
+{
+	Link_flushSession(g_link_node_address);
+	Link_dropPending(g_link_node_address);
+	g_link_is_up = TRUE;
+	g_link_is_resync_pending = TRUE;
+}
+
+/*
+ * Description:
+ * Returns TRUE if a heartbeat or an acknowledge carries another boot id
+ * than the last one heard from its sender, the sender then restarted
+ */
+static boolean Link_isPeerRestarted(const Link_MessageType* frame_Ptr)
+{
+	uint8* boot_id_Ptr = &g_link_peer_boot_ids[0];
+	boolean is_restarted;
+	if(((frame_Ptr->kind != LINK_HEARTBEAT) && (frame_Ptr->kind != LINK_HEARTBEAT_ACK)) ||
+			(frame_Ptr->length <= LINK_BOOT_ID_INDEX))
+	{
+		return FALSE;
+	}
+	if(g_link_own_address == LINK_MASTER_ADDRESS)
+	{
+		boot_id_Ptr = &g_link_peer_boot_ids[frame_Ptr->address - LINK_FIRST_NODE_ADDRESS];
+	}
+	is_restarted = (*boot_id_Ptr != LINK_NO_BOOT_ID) && (*boot_id_Ptr != frame_Ptr->payload[LINK_BOOT_ID_INDEX]);
+	*boot_id_Ptr = frame_Ptr->payload[LINK_BOOT_ID_INDEX];
+	return is_restarted;
+}
+
+/*
+ * Description:
+ * Called for each valid frame of the session, a new boot id, or a heartbeat
+ * or an acknowledge telling that the peer did not hear this ECU while the
+ * link is up, means the peer restarted
+ */
+static void Link_markAlive(const Link_MessageType* frame_Ptr, boolean is_restarted)
+{
+	g_link_is_peer_heard = TRUE;
+	g_link_missed_heartbeats = 0;
+	if((g_link_is_up == FALSE) || (is_restarted == TRUE) ||
+			(((frame_Ptr->kind == LINK_HEARTBEAT) || (frame_Ptr->kind == LINK_HEARTBEAT_ACK)) && (frame_Ptr->type == FALSE)))
+	{
+		Link_startSession();
+	}
+}
+
+/*
+ * Description:
+ * Answers a heartbeat with the status of this ECU, a node on the bus uses
+ * its turn for a request or event waiting to be sent instead
+ */
+static void Link_answerHeartbeat(const Link_MessageType* heartbeat_Ptr, boolean was_up)
+{
+	Link_MessageType ack;
+	uint8 ack_payload[LINK_BOOT_ID_INDEX + 1 + LINK_NODE_STATUS_SIZE];
+	uint8 byte_index;
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if((g_link_own_address != LINK_MASTER_ADDRESS) && (Link_sendDuePending() == TRUE))
+	{
+		return;
+	}
+#endif
+	ack_payload[LINK_BOOT_ID_INDEX] = g_link_boot_id;
+	for(byte_index = 0; byte_index < g_link_status_length; byte_index++)
+	{
+		ack_payload[LINK_BOOT_ID_INDEX + 1 + byte_index] = g_link_status[byte_index];
+	}
+	Link_fillMessage(&ack, LINK_HEARTBEAT_ACK, heartbeat_Ptr->id, was_up, ack_payload,
+			(uint8)(LINK_BOOT_ID_INDEX + 1 + g_link_status_length));
+	Link_transmit(&ack, heartbeat_Ptr->address);
+}
+
+/*
+ * Description:
+ * Handles a request or an event, a retransmission of one already received
+ * is answered from the cache and not delivered again
+ */
+static void Link_handleRequest(const Link_MessageType* frame_Ptr)
+{
+	Link_CacheType* cache_Ptr = Link_findCache(frame_Ptr->address, frame_Ptr->id);
+	uint8 queue_index;
+
+	if(cache_Ptr != NULL_PTR)
+	{
+		if(cache_Ptr->state != LINK_CACHE_IN_PROGRESS)
+		{
+			cache_Ptr->state = LINK_CACHE_REPLIED;
+			Link_transmit(&cache_Ptr->reply, frame_Ptr->address);
+		}
+		return; /* still being handled, the reply will be sent once ready */
+	}
+	if(g_link_rx_queue_count >= LINK_RX_QUEUE_SIZE)
+	{
+		return; /* no room, the peer retransmits */
+	}
+
+	/* the oldest cached reply is replaced */
+	cache_Ptr = &g_link_cache[g_link_cache_next];
+	g_link_cache_next = (uint8)((g_link_cache_next + 1) % LINK_REPLY_CACHE_SIZE);
+	Link_fillMessage(&cache_Ptr->reply, LINK_REPLY, frame_Ptr->id, frame_Ptr->type, NULL_PTR, 0);
+	cache_Ptr->reply.address = frame_Ptr->address;
+	cache_Ptr->state = LINK_CACHE_IN_PROGRESS;
+	if(frame_Ptr->kind == LINK_EVENT)
+	{
+		cache_Ptr->state = LINK_CACHE_REPLIED;
+		Link_transmit(&cache_Ptr->reply, frame_Ptr->address);
+	}
+
+	queue_index = (uint8)((g_link_rx_queue_head + g_link_rx_queue_count) % LINK_RX_QUEUE_SIZE);
+	g_link_rx_queue[queue_index] = *frame_Ptr;
+	g_link_rx_queue_count++;
+}
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+/*
+ * Description:
+ * Master only, sends the first reply that waited for the bus, returns
+ * FALSE if none is waiting
+ */
+static boolean Link_sendWaitingReply(void)
+{
+	uint8 cache_index;
+	for(cache_index = 0; cache_index < LINK_REPLY_CACHE_SIZE; cache_index++)
+	{
+		if(g_link_cache[cache_index].state == LINK_CACHE_REPLY_WAITING)
+		{
+			g_link_cache[cache_index].state = LINK_CACHE_REPLIED;
+			Link_transmit(&g_link_cache[cache_index].reply, g_link_cache[cache_index].reply.address);
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+#endif
+
+/*
+ * Description:
+ * Matches a reply with the request waiting for it, stray replies are dropped
+ */
+static void Link_handleReply(const Link_MessageType* frame_Ptr)
+{
+	uint8 pending_index;
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		if((g_link_pending[pending_index].state == LINK_ENTRY_WAITING) &&
+				(g_link_pending[pending_index].message.id == frame_Ptr->id) &&
+				(g_link_pending[pending_index].message.address == frame_Ptr->address))
+		{
+			/* nobody reads the result of an untracked event so its entry is released here */
+			g_link_pending[pending_index].state = ((g_link_pending[pending_index].message.kind == LINK_EVENT) &&
+					(g_link_pending[pending_index].is_tracked == FALSE)) ? LINK_ENTRY_FREE : LINK_ENTRY_DONE;
+			g_link_pending[pending_index].message = *frame_Ptr;
+			return;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Handles a frame that passed its CRC, the master takes the requests and
+ * events of every node but only the frames of the session node keep the
+ * link up. On the bus the master only takes the answer of the node it
+ * addressed, a node answering after the bus was taken back may have
+ * overlapped the next node and retransmits
+ */
+static void Link_handleFrame(Link_MessageType* frame_Ptr)
+{
+	boolean was_up = g_link_is_up;
+	boolean is_restarted;
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if(g_link_own_address == LINK_MASTER_ADDRESS)
+	{
+		if((g_link_is_bus_held == FALSE) || (frame_Ptr->address != g_link_bus_address))
+		{
+			return;
+		}
+		g_link_is_bus_held = FALSE; /* a node answers with one frame */
+	}
+	else
+	{
+		frame_Ptr->address = g_link_node_address;
+		if(frame_Ptr->kind == LINK_REQUEST)
+		{
+			g_link_reply_window_id = frame_Ptr->id;
+			g_link_reply_window_tick = Tick_getTicks();
+		}
+	}
+#else
+	frame_Ptr->address = g_link_node_address;
+#endif
+	if((g_link_own_address == LINK_MASTER_ADDRESS) && (Link_isNodeAddress(frame_Ptr->address) == FALSE))
+	{
+		return; /* nothing answers a broadcast */
+	}
+	is_restarted = Link_isPeerRestarted(frame_Ptr);
+	if(g_link_own_address == LINK_MASTER_ADDRESS)
+	{
+		Link_updateNode(frame_Ptr->address, frame_Ptr, is_restarted);
+	}
+	if(frame_Ptr->address == g_link_node_address)
+	{
+		Link_markAlive(frame_Ptr, is_restarted);
+	}
+
+	switch(frame_Ptr->kind)
+	{
+	case LINK_REPLY:
+		Link_handleReply(frame_Ptr);
+		break;
+	case LINK_HEARTBEAT:
+		Link_answerHeartbeat(frame_Ptr, was_up);
+		break;
+	case LINK_HEARTBEAT_ACK:
+		if((frame_Ptr->address == g_link_node_address) && (g_link_is_heartbeat_acked == FALSE) &&
+				(frame_Ptr->id == g_link_heartbeat_id))
+		{
+			g_link_is_heartbeat_acked = TRUE;
+			g_link_round_trip_ms = (uint16)Tick_elapsedSince(g_link_heartbeat_tick);
+		}
+		break;
+	case LINK_EVENT:
+		if(frame_Ptr->id == LINK_NO_ID)
+		{
+			/* a broadcast, only the last one matters */
+			g_link_broadcast_rx = *frame_Ptr;
+			g_link_is_broadcast_received = TRUE;
+		}
+		else
+		{
+			Link_handleRequest(frame_Ptr);
+		}
+		break;
+	default:
+		Link_handleRequest(frame_Ptr);
+		break;
+	}
+}
+
+static void Link_parseByte(uint8 received_byte)
+{
+	switch(g_link_rx_state)
+	{
+	case LINK_RX_HUNT:
+		if(received_byte == LINK_START_OF_FRAME)
+		{
+			g_link_rx_crc = 0;
+			g_link_rx_state = LINK_RX_SOURCE;
+		}
+		return;
+	case LINK_RX_SOURCE:
+		g_link_rx_frame.address = received_byte;
+		g_link_rx_state = LINK_RX_KIND;
+		break;
+	case LINK_RX_KIND:
+		g_link_rx_frame.kind = received_byte;
+		g_link_rx_state = (received_byte <= LINK_HEARTBEAT_ACK) ? LINK_RX_ID : LINK_RX_HUNT;
+		break;
+	case LINK_RX_ID:
+		g_link_rx_frame.id = received_byte;
+		g_link_rx_state = LINK_RX_TYPE;
+		break;
+	case LINK_RX_TYPE:
+		g_link_rx_frame.type = received_byte;
+		g_link_rx_state = LINK_RX_LENGTH;
+		break;
+	case LINK_RX_LENGTH:
+		g_link_rx_frame.length = received_byte;
+		g_link_rx_index = 0;
+		if(received_byte > LINK_MAX_PAYLOAD_SIZE)
+		{
+			g_link_rx_state = LINK_RX_HUNT;
+		}
+		else
+		{
+			g_link_rx_state = (received_byte == 0) ? LINK_RX_CRC : LINK_RX_PAYLOAD;
+		}
+		break;
+	case LINK_RX_PAYLOAD:
+		g_link_rx_frame.payload[g_link_rx_index++] = received_byte;
+		if(g_link_rx_index >= g_link_rx_frame.length)
+		{
+			g_link_rx_state = LINK_RX_CRC;
+		}
+		break;
+	case LINK_RX_CRC:
+		g_link_rx_state = LINK_RX_HUNT;
+		if(received_byte != g_link_rx_crc)
+		{
+			return;
+		}
+		Link_handleFrame(&g_link_rx_frame);
+		return;
+	}
+	g_link_rx_crc = Link_crcUpdate(g_link_rx_crc, received_byte);
+}
+
+static uint8 Link_startRequest(uint8 kind, uint8 address, uint8 type, const uint8* payload_Ptr, uint8 length,
+		boolean is_tracked)
+{
+	uint8 pending_index, free_index = LINK_MAX_PENDING;
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		if(g_link_pending[pending_index].state == LINK_ENTRY_FREE)
+		{
+			if(free_index == LINK_MAX_PENDING)
+			{
+				free_index = pending_index;
+			}
+		}
+		else if((kind == LINK_EVENT) && (is_tracked == FALSE) &&
+				(g_link_pending[pending_index].message.kind == LINK_EVENT) &&
+				(g_link_pending[pending_index].is_tracked == FALSE) &&
+				(g_link_pending[pending_index].message.type == type) &&
+				(g_link_pending[pending_index].message.address == address))
+		{
+			/* the newer state of the same type takes the slot of the older one */
+			free_index = pending_index;
+			break;
+		}
+	}
+	if(free_index == LINK_MAX_PENDING)
+	{
+		return LINK_NO_ID;
+	}
+	pending_index = free_index;
+	g_link_next_id++;
+	if(g_link_next_id == LINK_NO_ID)
+	{
+		g_link_next_id++;
+	}
+	Link_fillMessage(&g_link_pending[pending_index].message, kind, g_link_next_id, type, payload_Ptr, length);
+	g_link_pending[pending_index].message.address = address;
+	g_link_pending[pending_index].state = LINK_ENTRY_WAITING;
+	g_link_pending[pending_index].retries_left = LINK_MAX_RETRIES;
+	g_link_pending[pending_index].is_sent = FALSE;
+	g_link_pending[pending_index].is_tracked = is_tracked;
+	if(Link_isBusFree() == TRUE)
+	{
+		Link_sendDuePending();
+	}
+	return g_link_next_id;
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void Link_init(uint8 own_address)
+{
+	uint8 entry_index;
+	for(entry_index = 0; entry_index < LINK_MAX_PENDING; entry_index++)
+	{
+		g_link_pending[entry_index].state = LINK_ENTRY_FREE;
+	}
+	for(entry_index = 0; entry_index < LINK_REPLY_CACHE_SIZE; entry_index++)
+	{
+		g_link_cache[entry_index].state = LINK_CACHE_FREE;
+	}
+	for(entry_index = 0; entry_index < LINK_MAX_NODES; entry_index++)
+	{
+		g_link_nodes[entry_index].is_up = FALSE;
+		g_link_nodes[entry_index].missed_polls = 0;
+		g_link_peer_boot_ids[entry_index] = LINK_NO_BOOT_ID;
+	}
+	g_link_boot_id++;
+	if(g_link_boot_id == LINK_NO_BOOT_ID)
+	{
+		g_link_boot_id++;
+	}
+	g_link_rx_queue_count = 0;
+	g_link_is_broadcast_received = FALSE;
+	g_link_own_address = own_address;
+	g_link_node_address = (own_address == LINK_MASTER_ADDRESS) ? LINK_FIRST_NODE_ADDRESS : LINK_MASTER_ADDRESS;
+	g_link_rx_state = LINK_RX_HUNT;
+	g_link_is_up = FALSE;
+	g_link_is_resync_pending = FALSE;
+	g_link_missed_heartbeats = 0;
+	g_link_round_trip_ms = LINK_NO_ROUND_TRIP;
+	g_link_period_tick = Tick_getTicks();
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	g_link_is_bus_held = FALSE;
+	g_link_is_broadcast_waiting = FALSE;
+	UART_setAddress(own_address);
+#endif
+	/* a peer that was up finds out this ECU restarted, a node waits to be polled */
+	if(Link_isBusFree() == TRUE)
+	{
+		Link_sendHeartbeat(g_link_node_address);
+	}
+}
+
+void Link_poll(void)
+{
+	uint8 pending_index;
+
+	if((g_link_rx_state != LINK_RX_HUNT) && (Tick_elapsedSince(g_link_rx_last_tick) >= LINK_RX_GAP_TIMEOUT_MS))
+	{
+		g_link_rx_state = LINK_RX_HUNT; /* the rest of the frame was lost */
+	}
+	while(UART_isByteReceived() == TRUE)
+	{
+		g_link_rx_last_tick = Tick_getTicks();
+		Link_parseByte(UART_recieveByte());
+	}
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if((g_link_is_bus_held == TRUE) && (g_link_rx_state == LINK_RX_HUNT) &&
+			(Tick_elapsedSince(g_link_bus_tick) >= LINK_BUS_RESPONSE_TIMEOUT_MS) &&
+			(Tick_elapsedSince(g_link_rx_last_tick) >= LINK_BUS_RESPONSE_TIMEOUT_MS))
+	{
+		g_link_is_bus_held = FALSE;
+		Link_missNode(g_link_bus_address);
+	}
+#endif
+
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		if((g_link_pending[pending_index].state == LINK_ENTRY_WAITING) && (g_link_pending[pending_index].is_sent == TRUE) &&
+				(g_link_pending[pending_index].retries_left == 0) &&
+				(Tick_elapsedSince(g_link_pending[pending_index].sent_tick) >= LINK_REPLY_TIMEOUT_MS))
+		{
+			g_link_pending[pending_index].state = ((g_link_pending[pending_index].message.kind == LINK_EVENT) &&
+					(g_link_pending[pending_index].is_tracked == FALSE)) ? LINK_ENTRY_FREE : LINK_ENTRY_FAILED;
+		}
+	}
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	/* a reply does not hold the bus, those waiting go out before a new request */
+	while((Link_isBusFree() == TRUE) && (Link_sendWaitingReply() == TRUE)){}
+#endif
+	while((Link_isBusFree() == TRUE) && (Link_sendDuePending() == TRUE)){}
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if((g_link_is_broadcast_waiting == TRUE) && (Link_isBusFree() == TRUE))
+	{
+		g_link_is_broadcast_waiting = FALSE;
+		Link_transmit(&g_link_broadcast_tx, LINK_BROADCAST_ADDRESS);
+	}
+#endif
+
+	if(Tick_elapsedSince(g_link_period_tick) >=
+			((g_link_own_address == LINK_MASTER_ADDRESS) ? LINK_HEARTBEAT_PERIOD_MS : LINK_NODE_PERIOD_MS))
+	{
+		g_link_period_tick = Tick_getTicks();
+		if(g_link_is_peer_heard == FALSE)
+		{
+			if(g_link_missed_heartbeats < LINK_HEARTBEAT_MISS_THRESHOLD)
+			{
+				g_link_missed_heartbeats++;
+			}
+			if(g_link_missed_heartbeats >= LINK_HEARTBEAT_MISS_THRESHOLD)
+			{
+				/* the next heartbeats tell the peer to resync once it hears them */
+				g_link_is_up = FALSE;
+			}
+#if (UART_BUS_MODE_SELECT != UART_BUS_MULTI_DROP)
+			if(g_link_own_address == LINK_MASTER_ADDRESS)
+			{
+				Link_missNode(g_link_node_address);
+			}
+#endif
+		}
+		g_link_is_peer_heard = FALSE;
+#if (UART_BUS_MODE_SELECT != UART_BUS_MULTI_DROP)
+		Link_sendHeartbeat(g_link_node_address);
+#endif
+	}
+
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	/* every other slot polls the next node out of session */
+	if((Link_isBusFree() == TRUE) && (Tick_elapsedSince(g_link_slot_tick) >= LINK_BUS_SLOT_MS))
+	{
+		g_link_slot_tick = Tick_getTicks();
+		if(g_link_is_session_slot == TRUE)
+		{
+			Link_sendHeartbeat(g_link_node_address);
+		}
+		else
+		{
+			/* with a single node polled it is polled every slot */
+			do
+			{
+				g_link_poll_address = (g_link_poll_address >= (LINK_FIRST_NODE_ADDRESS + LINK_BUS_POLLED_NODES - 1)) ?
+						LINK_FIRST_NODE_ADDRESS : (uint8)(g_link_poll_address + 1);
+			}while((g_link_poll_address == g_link_node_address) && (LINK_BUS_POLLED_NODES > 1u));
+			Link_sendHeartbeat(g_link_poll_address);
+		}
+		g_link_is_session_slot = !g_link_is_session_slot;
+	}
+#endif
+}
+
+uint8 Link_sendRequest(uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	return Link_startRequest(LINK_REQUEST, g_link_node_address, type, payload_Ptr, length, FALSE);
+}
+
+uint8 Link_sendEvent(uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	return Link_startRequest(LINK_EVENT, g_link_node_address, type, payload_Ptr, length, FALSE);
+}
+
+uint8 Link_sendEventTo(uint8 address, uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	if(g_link_own_address != LINK_MASTER_ADDRESS)
+	{
+		address = LINK_MASTER_ADDRESS; /* a node only talks to the master */
+	}
+	else if(Link_isNodeAddress(address) == FALSE)
+	{
+		return LINK_NO_ID;
+	}
+	return Link_startRequest(LINK_EVENT, address, type, payload_Ptr, length, FALSE);
+}
+
+uint8 Link_sendTrackedEventTo(uint8 address, uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+	if(g_link_own_address != LINK_MASTER_ADDRESS)
+	{
+		address = LINK_MASTER_ADDRESS;
+	}
+	else if(Link_isNodeAddress(address) == FALSE)
+	{
+		return LINK_NO_ID;
+	}
+	return Link_startRequest(LINK_EVENT, address, type, payload_Ptr, length, TRUE);
+}
+
+Link_StatusType Link_getResult(uint8 id, Link_MessageType* reply_Ptr)
+{
+	uint8 pending_index;
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		if((g_link_pending[pending_index].state != LINK_ENTRY_FREE) && (g_link_pending[pending_index].message.id == id))
+		{
+			switch(g_link_pending[pending_index].state)
+			{
+			case LINK_ENTRY_WAITING:
+				return LINK_PENDING;
+			case LINK_ENTRY_DONE:
+				*reply_Ptr = g_link_pending[pending_index].message;
+				g_link_pending[pending_index].state = LINK_ENTRY_FREE;
+				return LINK_DONE;
+			default:
+				g_link_pending[pending_index].state = LINK_ENTRY_FREE;
+				return LINK_FAILED;
+			}
+		}
+	}
+	return LINK_FAILED;
+}
+
+void Link_cancel(uint8 id)
+{
+	uint8 pending_index;
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		if((g_link_pending[pending_index].state != LINK_ENTRY_FREE) && (g_link_pending[pending_index].message.id == id))
+		{
+			g_link_pending[pending_index].state = LINK_ENTRY_FREE;
+		}
+	}
+}
+
+Link_StatusType Link_call(uint8 type, const uint8* payload_Ptr, uint8 length, Link_MessageType* reply_Ptr)
+{
+	Link_StatusType status;
+	uint8 id = Link_sendRequest(type, payload_Ptr, length);
+	if(id == LINK_NO_ID)
+	{
+		return LINK_FAILED;
+	}
+	do
+	{
+		Link_poll();
+		status = Link_getResult(id, reply_Ptr);
+	}while(status == LINK_PENDING);
+	return status;
+}
+
+boolean Link_receive(Link_MessageType* message_Ptr)
+{
+	if(g_link_rx_queue_count == 0)
+	{
+		return FALSE;
+	}
+	*message_Ptr = g_link_rx_queue[g_link_rx_queue_head];
+	g_link_rx_queue_head = (uint8)((g_link_rx_queue_head + 1) % LINK_RX_QUEUE_SIZE);
+	g_link_rx_queue_count--;
+	return TRUE;
+}
+
+void Link_sendReply(const Link_MessageType* request_Ptr, const uint8* payload_Ptr, uint8 length)
+{
+	Link_CacheType* cache_Ptr = Link_findCache(request_Ptr->address, request_Ptr->id);
+	Link_MessageType reply;
+
+	if(request_Ptr->kind != LINK_REQUEST)
+	{
+		return; /* events were already acknowledged */
+	}
+	Link_fillMessage(&reply, LINK_REPLY, request_Ptr->id, request_Ptr->type, payload_Ptr, length);
+	reply.address = request_Ptr->address;
+	if(cache_Ptr != NULL_PTR)
+	{
+		cache_Ptr->reply = reply;
+		cache_Ptr->state = LINK_CACHE_REPLIED;
+	}
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	/*
+	 * too late for the bus turn, the retransmitted request gets it from the
+	 * cache. Half the master timeout leaves time for the reply to go out
+	 */
+	if((g_link_own_address != LINK_MASTER_ADDRESS) && ((g_link_reply_window_id != request_Ptr->id) ||
+			(Tick_elapsedSince(g_link_reply_window_tick) >= (LINK_BUS_RESPONSE_TIMEOUT_MS / 2u))))
+	{
+		return;
+	}
+	g_link_reply_window_id = LINK_NO_ID;
+	/* the master waits for the node holding the bus, Link_poll() sends the reply once it answered */
+	if((g_link_own_address == LINK_MASTER_ADDRESS) && (Link_isBusFree() == FALSE))
+	{
+		if(cache_Ptr != NULL_PTR)
+		{
+			cache_Ptr->state = LINK_CACHE_REPLY_WAITING;
+		}
+		return;
+	}
+#endif
+	Link_transmit(&reply, reply.address);
+}
+
+boolean Link_isUp(void)
+{
+	return g_link_is_up;
+}
+
+uint16 Link_getRoundTripTime(void)
+{
+	return g_link_round_trip_ms;
+}
+
+boolean Link_takeResync(void)
+{
+	boolean is_resync_pending = g_link_is_resync_pending;
+	g_link_is_resync_pending = FALSE;
+	return is_resync_pending;
+}
+
+void Link_setStatus(const uint8* status_Ptr, uint8 length)
+{
+	uint8 byte_index;
+	if(length > LINK_NODE_STATUS_SIZE)
+	{
+		length = LINK_NODE_STATUS_SIZE;
+	}
+	for(byte_index = 0; byte_index < length; byte_index++)
+	{
+		g_link_status[byte_index] = status_Ptr[byte_index];
+	}
+	g_link_status_length = length;
+}
+
+void Link_selectNode(uint8 address)
+{
+	uint8 pending_index;
+	if((g_link_own_address != LINK_MASTER_ADDRESS) || (Link_isNodeAddress(address) == FALSE) ||
+			(address == g_link_node_address))
+	{
+		return;
+	}
+	/* the requests waiting for the previous node are dropped */
+	for(pending_index = 0; pending_index < LINK_MAX_PENDING; pending_index++)
+	{
+		if(g_link_pending[pending_index].message.address == g_link_node_address)
+		{
+			g_link_pending[pending_index].state = LINK_ENTRY_FREE;
+		}
+	}
+	Link_flushSession(g_link_node_address);
+	g_link_node_address = address;
+	g_link_is_up = FALSE;
+	g_link_is_resync_pending = FALSE;
+	g_link_missed_heartbeats = 0;
+	g_link_is_heartbeat_acked = TRUE;
+	g_link_round_trip_ms = LINK_NO_ROUND_TRIP;
+}
+
+boolean Link_getNodeStatus(uint8 address, Link_NodeStatusType* status_Ptr)
+{
+	if(Link_isNodeAddress(address) == FALSE)
+	{
+		return FALSE;
+	}
+	*status_Ptr = g_link_nodes[address - LINK_FIRST_NODE_ADDRESS];
+	return TRUE;
+}
+
+void Link_broadcast(uint8 type, const uint8* payload_Ptr, uint8 length)
+{
+#if (UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP)
+	if(g_link_own_address != LINK_MASTER_ADDRESS)
+	{
+		return;
+	}
+	/* a newer state replaces the one still waiting */
+	Link_fillMessage(&g_link_broadcast_tx, LINK_EVENT, LINK_NO_ID, type, payload_Ptr, length);
+	g_link_is_broadcast_waiting = TRUE;
+	if(Link_isBusFree() == TRUE)
+	{
+		g_link_is_broadcast_waiting = FALSE;
+		Link_transmit(&g_link_broadcast_tx, LINK_BROADCAST_ADDRESS);
+	}
+#else
+	Link_MessageType broadcast;
+	if(g_link_own_address != LINK_MASTER_ADDRESS)
+	{
+		return;
+	}
+	Link_fillMessage(&broadcast, LINK_EVENT, LINK_NO_ID, type, payload_Ptr, length);
+	Link_transmit(&broadcast, LINK_BROADCAST_ADDRESS);
+#endif
+}
+
+boolean Link_receiveBroadcast(Link_MessageType* message_Ptr)
+{
+	if(g_link_is_broadcast_received == FALSE)
+	{
+		return FALSE;
+	}
+	*message_Ptr = g_link_broadcast_rx;
+	g_link_is_broadcast_received = FALSE;
+	return TRUE;
+}
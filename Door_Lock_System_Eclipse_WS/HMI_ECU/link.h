@@ -0,0 +1,265 @@
+/*
+ *  File: Header file for ECU link RPC layer
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef LINK_H_
+#define LINK_H_
+
+#include "std_types.h"
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/*
+ * Frame on the UART:
+ * start | source address | kind | correlation id | type | length | payload | CRC-8
+ * the CRC covers the source address up to the end of the payload, a frame
+ * failing it is dropped and the sender retransmits
+ */
+#define LINK_START_OF_FRAME				0x7Eu
+#define LINK_FRAME_OVERHEAD				7u
+#define LINK_MAX_PAYLOAD_SIZE			12u
+
+/* a frame is abandoned if its bytes stop arriving for this long */
+#define LINK_RX_GAP_TIMEOUT_MS			20u
+/* time to wait for a reply before retransmitting the same frame */
+#define LINK_REPLY_TIMEOUT_MS			150u
+#define LINK_MAX_RETRIES				3u
+
+/* requests of this ECU waiting for their replies */
+#define LINK_MAX_PENDING				4u
+/* received requests and events not read by the application yet */
+#define LINK_RX_QUEUE_SIZE				4u
+/* last replies sent, a retransmitted request gets its cached reply again */
+#define LINK_REPLY_CACHE_SIZE			4u
+
+/* correlation ids start at 1, 0 means no request or a broadcast */
+#define LINK_NO_ID						0u
+
+/*
+ * A heartbeat is sent each period and acknowledged by the peer link layer,
+ * both carry whether the sender was already hearing the peer so an ECU that
+ * rebooted or lost the link makes the other one resync on its first frame.
+ * Both also carry the boot id of the sender, it changes on each restart so
+ * a reboot missed by the first frames is still found by the next ones.
+ * Any valid frame proves the peer alive, the link is down after this many
+ * periods in a row without one
+ */
+#define LINK_HEARTBEAT_PERIOD_MS		250u
+#define LINK_HEARTBEAT_MISS_THRESHOLD	3u
+/* no heartbeat was acknowledged yet */
+#define LINK_NO_ROUND_TRIP				0xFFFFu
+/* first payload byte of a heartbeat or acknowledge, the node status follows it */
+#define LINK_BOOT_ID_INDEX				0u
+/* no boot id heard from the peer yet */
+#define LINK_NO_BOOT_ID					0u
+
+/*
+ * One master and nodes 1 to LINK_MAX_NODES, the master is the HMI ECU when
+ * it drives several doors or the Control ECU when several HMI panels share
+ * its door. On the multi-drop bus a node only transmits in answer to a frame
+ * sent to it, the master heartbeats the node it is in session with and the
+ * other nodes in turn. A point-to-point peer is node 1
+ */
+#define LINK_MASTER_ADDRESS				0u		/* same as UART_NO_ADDRESS */
+#define LINK_FIRST_NODE_ADDRESS			1u
+#define LINK_MAX_NODES					32u
+/* same as UART_BROADCAST_ADDRESS, heard by every node and never answered */
+#define LINK_BROADCAST_ADDRESS			0xFFu
+/* nodes polled by the master, lower it to the nodes installed for a shorter poll round */
+#define LINK_BUS_POLLED_NODES			LINK_MAX_NODES
+
+/* the master sends one heartbeat per slot, alternating session node and polled node */
+#define LINK_BUS_SLOT_MS				25u
+/* the bus is given back to the master if the node does not answer in this time */
+#define LINK_BUS_RESPONSE_TIMEOUT_MS	20u
+/* a node out of session hears the master once per poll round */
+#define LINK_BUS_POLL_ROUND_MS			(2u * LINK_BUS_POLLED_NODES * LINK_BUS_SLOT_MS)
+
+/* application status a node returns in each heartbeat acknowledge */
+#define LINK_NODE_STATUS_SIZE			2u
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+typedef enum
+{
+	LINK_REQUEST,		/* answered by the application with Link_sendReply() */
+	LINK_REPLY,
+	LINK_EVENT,			/* acknowledged by the link layer itself, carries no reply */
+	LINK_HEARTBEAT,		/* link layer only, never delivered to the application */
+	LINK_HEARTBEAT_ACK
+}Link_KindType;
+
+typedef enum
+{
+	LINK_PENDING,
+	LINK_DONE,
+	LINK_FAILED			/* no reply after all retries, or unknown id */
+}Link_StatusType;
+
+/* last known state of a node, kept by the master */
+typedef struct
+{
+	boolean is_up;
+	uint8 missed_polls;
+	uint8 status[LINK_NODE_STATUS_SIZE];
+}Link_NodeStatusType;
+
+typedef struct
+{
+	uint8 kind;
+	uint8 id;
+	uint8 type;			/* message type from door_lock_states.h */
+	uint8 length;
+	uint8 payload[LINK_MAX_PAYLOAD_SIZE];
+	uint8 address;		/* not sent, node the message comes from or goes to, LINK_MASTER_ADDRESS on a node */
+}Link_MessageType;
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Clears the pending requests, the received queue and the reply cache and
+ * announces this ECU with a heartbeat, UART_init() and Tick_init() must be
+ * called first. The HMI ECU passes LINK_MASTER_ADDRESS, a Control ECU its
+ * node address
+ */
+void Link_init(uint8 own_address);
+
+/*
+ * Description:
+ * Parses the received bytes, retransmits the requests whose reply is late
+ * and sends the heartbeat, must be called often from the main loop
+ */
+void Link_poll(void);
+
+/*
+ * Description:
+ * Sends a request and returns its correlation id, or LINK_NO_ID if too
+ * many requests are already waiting
+ */
+uint8 Link_sendRequest(uint8 type, const uint8* payload_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Sends an event, retransmitted until the peer link layer acknowledges it
+ * or the retries run out. An event carries the latest state of its type:
+ * one still waiting for the same node with the same type is replaced, so
+ * an older state is never delivered after a newer one. Returns LINK_NO_ID
+ * if the pending table is full, the event is then not sent at all
+ */
+uint8 Link_sendEvent(uint8 type, const uint8* payload_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Same as Link_sendEvent() but the master may send it to a node out of
+ * session, the address of a received message answers its sender
+ */
+uint8 Link_sendEventTo(uint8 address, uint8 type, const uint8* payload_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Same as Link_sendEventTo() but the event never replaces another one and
+ * its entry is kept once acknowledged or failed, Link_getResult() then
+ * tells whether the peer took it and releases the id
+ */
+uint8 Link_sendTrackedEventTo(uint8 address, uint8 type, const uint8* payload_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Returns the state of a request sent by Link_sendRequest() or of a tracked
+ * event, once done the reply is copied and the id is released
+ */
+Link_StatusType Link_getResult(uint8 id, Link_MessageType* reply_Ptr);
+
+/*
+ * Description:
+ * Releases the id of a request or tracked event whose result is not
+ * wanted any more, it is not sent again
+ */
+void Link_cancel(uint8 id);
+
+/*
+ * Description:
+ * Sends a request and waits for its reply or for the retries to run out,
+ * messages received meanwhile are kept for Link_receive()
+ */
+Link_StatusType Link_call(uint8 type, const uint8* payload_Ptr, uint8 length, Link_MessageType* reply_Ptr);
+
+/*
+ * Description:
+ * Takes the oldest received request or event, returns FALSE if none. The
+ * master receives them from every node, their address tells which one
+ */
+boolean Link_receive(Link_MessageType* message_Ptr);
+
+/*
+ * Description:
+ * Answers a request taken by Link_receive()
+ */
+void Link_sendReply(const Link_MessageType* request_Ptr, const uint8* payload_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Returns TRUE while frames from the peer keep arriving
+ */
+boolean Link_isUp(void);
+
+/*
+ * Description:
+ * Returns the round trip time in ms of the last acknowledged heartbeat,
+ * LINK_NO_ROUND_TRIP if none
+ */
+uint16 Link_getRoundTripTime(void);
+
+/*
+ * Description:
+ * Returns TRUE once each time the peer appears, comes back after the link
+ * was down or is found to have restarted. The reply cache and the received
+ * queue belong to the old session and are already flushed, the application
+ * must bring its state machine back to a known state with the peer
+ */
+boolean Link_takeResync(void);
+
+/*
+ * Description:
+ * Sets the status a node returns in its heartbeat acknowledges
+ */
+void Link_setStatus(const uint8* status_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Master only, moves the session to another node. The requests waiting
+ * are dropped and Link_takeResync() reports the new node once it answers
+ */
+void Link_selectNode(uint8 address);
+
+/*
+ * Description:
+ * Master only, copies the last known state of a node, returns FALSE for
+ * an address out of range
+ */
+boolean Link_getNodeStatus(uint8 address, Link_NodeStatusType* status_Ptr);
+
+/*
+ * Description:
+ * Master only, sends an event to every node at once. It is not acknowledged
+ * so it suits a state repeated periodically, on the bus only the last one
+ * waiting for the bus is sent
+ */
+void Link_broadcast(uint8 type, const uint8* payload_Ptr, uint8 length);
+
+/*
+ * Description:
+ * Node only, copies the last broadcast received, returns FALSE if none
+ * arrived since the last call
+ */
+boolean Link_receiveBroadcast(Link_MessageType* message_Ptr);
+
+#endif /* LINK_H_ */
@@ -9,35 +9,71 @@
 
 #include <avr/io.h>
 #include <util/delay.h>
+#include <avr/pgmspace.h>
 #include "lcd.h"
 #include "keypad.h"
 #include "uart.h"
-#include "timer.h"
+#include "link.h"
+#include "tick.h"
 #include "door_lock_states.h"
 
 #define MAX_NUM_OF_ATTEMPTS		3
 #define PASSWORD_MAX_SIZE       5
-#define NUM_OF_CTC_PER_15_SEC		15
-#define NUM_OF_CTC_PER_MIN			60
+#define SYSTEM_LOCKOUT_TIME_MS		60000UL
+/* average time between key presses below this value can't be typed by a human */
+#define MIN_HUMAN_KEY_INTERVAL_MS	80
+#define DOOR_FAULT_MESSAGE_TIME_MS	3000UL
+#define NO_STATE_RECEIVED			0u
+#define LINK_ERROR_MESSAGE_TIME_MS	1000UL
+/* opens the door list from the main menu when the doors share a bus */
+#define DOOR_SELECT_KEY				'*'
+/*
+ * LINK_MASTER_ADDRESS when this HMI ECU drives one door or the doors sharing
+ * the bus, a panel number from LINK_FIRST_NODE_ADDRESS when several panels
+ * share one Control ECU which is then the master
+ */
+#define HMI_LINK_ADDRESS			LINK_MASTER_ADDRESS
+#define DOOR_SELECT_ENABLED			((UART_BUS_MODE_SELECT == UART_BUS_MULTI_DROP) && (HMI_LINK_ADDRESS == LINK_MASTER_ADDRESS))
+/* a panel told busy syncs again after this time if the door free broadcast was missed */
+#define PANEL_BUSY_RETRY_TIME_MS	5000UL
+/* no door event for this long and the Control ECU is synced again to find the door */
+#define DOOR_EVENT_TIMEOUT_MS		DOOR_MOVE_TIMEOUT_MS
 
-void timer_callBack_motorOP(void);
-void timer_callBack_systemNOK_OP(void);
-void read_send_password(void);
+boolean poll_link(void);
+uint8 wait_for_key(void);
+uint8 read_password(uint8* password, boolean* is_typing_too_fast_Ptr);
+uint8 control_request(uint8 request_type, const uint8* payload_Ptr, uint8 length);
+uint8 wait_for_door_event(void);
 void new_password_task(void);
+void door_session_task(void);
+void door_fault_task(void);
+void door_reopen_task(void);
+void lockout_task(uint32 lockout_time_ms);
+void resync_task(void);
+void panel_busy_task(void);
+#if DOOR_SELECT_ENABLED
+void door_select_task(void);
+#endif
 
-uint8 system_ticks = 0, is_timer_finished = FALSE;
-uint8 motor_ticks = 0, is_door_open = FALSE, password_size = 0;
+uint8 password_size = 0;
+/* set when the link comes back or the Control ECU restarts, the running task gives up */
+boolean is_resync_needed = TRUE;
+/* last event pushed by the Control ECU, its payload is read by the door tasks */
+Link_MessageType door_event;
+/* link address of the Control ECU the session is with */
+uint8 selected_door = (HMI_LINK_ADDRESS == LINK_MASTER_ADDRESS) ? LINK_FIRST_NODE_ADDRESS : LINK_MASTER_ADDRESS;
 
 int main(void) {
-	uint8 keypad_pressedKey_value, is_password_correct = FALSE_PASSCODE_ID, num_of_attempts = 0, current_state;
+	uint8 keypad_pressedKey_value, is_password_correct = FALSE_PASSCODE_ID, num_of_attempts = 0;
+	uint8 login_attempt[PASSWORD_MAX_SIZE], login_attempt_size;
+	boolean is_typing_too_fast;
 	/*************************************************
 	 * 				Intialization Stage
 	 *************************************************/
 	/*
 	 * initializing MCAL layer components
 	 */
-	UART_ConfigType uart_config = {DATA_8_BIT, NO_PARITY, UART_1_STOP_BIT, 19200};
-	Timer_ConfigType timer_config = {0, 7811, TIMER1, F_CLK_PRESCALE_1024, TIMER_COMPARE_MODE};
+	UART_ConfigType uart_config = {UART_BUS_DATA_BITS, NO_PARITY, UART_1_STOP_BIT, 19200};
 	UART_init(&uart_config);
 	SREG|=(1<<7);/* Global interrupt enable */
 
@@ -45,84 +81,90 @@ int main(void) {
 	 * initializing MCAL layer components
 	 */
 	LCD_init();
-	/* Syncing the ECUs */
-	UART_sendByte(UART_SYNC_CHAR);
-	while(UART_recieveByte() != UART_SYNC_CHAR);
-	/* Assigning a password for the system */
-	new_password_task();
+	Tick_init();
+	KEYPAD_init(NULL_PTR);
+	/* the first pass syncs the ECUs, retried until the Control ECU is up */
+	Link_init(HMI_LINK_ADDRESS);
 	while (TRUE) {
+		if(is_resync_needed == TRUE)
+		{
+			/* the Control ECU tells where it resumed, the login starts over */
+			resync_task();
+			is_password_correct = FALSE_PASSCODE_ID;
+			num_of_attempts = 0;
+			continue;
+		}
 		if(is_password_correct == FALSE_PASSCODE_ID)
 		{
-			if(num_of_attempts == MAX_NUM_OF_ATTEMPTS)
+			if(num_of_attempts >= MAX_NUM_OF_ATTEMPTS)
 			{
-				Timer_init(&timer_config);
-				Timer_setCallBack(timer_callBack_systemNOK_OP, TIMER1);
-
-				LCD_clearScreen();
-				LCD_displayStringRowColumn(0,1, "System LOCKED");
-				LCD_displayStringRowColumn(1,0, "wait for 1 min");
-
-				while(is_timer_finished == FALSE){}
-				is_timer_finished = FALSE;
+				lockout_task(SYSTEM_LOCKOUT_TIME_MS);
 				num_of_attempts = 0;
-				Timer_deInit(TIMER1);
-				/* system ok send */
+				if(is_resync_needed == TRUE)
+				{
+					continue;
+				}
 			}
 
 			LCD_clearScreen();
-			LCD_displayStringRowColumn(0,0,"+ : OPEN DOOR");
-			LCD_displayStringRowColumn(1,0,"- : CHANGE PASS");
+#if DOOR_SELECT_ENABLED
+			LCD_displayStringRowColumn_P(0,0,PSTR("+:OPEN *:DOOR"));
+			LCD_moveCursor(0,14);
+			LCD_displayInteger(selected_door, 2, LCD_FORMAT_SPACE_PAD);
+#else
+			LCD_displayStringRowColumn_P(0,0,PSTR("+ : OPEN DOOR"));
+#endif
+			LCD_displayStringRowColumn_P(1,0,PSTR("- : CHANGE PASS"));
+			LCD_flush();
 			do
 			{
-				keypad_pressedKey_value = KEYPAD_getPressedKey();
-				_delay_ms(400); /* pressed key latency */
-			}while((keypad_pressedKey_value != DOOR_OPEN_ID) && (keypad_pressedKey_value != CHANGE_PASSWORD_ID));
+				keypad_pressedKey_value = wait_for_key();
+#if DOOR_SELECT_ENABLED
+				if(keypad_pressedKey_value == DOOR_SELECT_KEY)
+				{
+					door_select_task();
+				}
+#endif
+			}while((keypad_pressedKey_value != DOOR_OPEN_ID) && (keypad_pressedKey_value != CHANGE_PASSWORD_ID) &&
+					(is_resync_needed == FALSE));
+			if(is_resync_needed == TRUE)
+			{
+				continue;
+			}
 
 			do{
 				LCD_clearScreen();
-				LCD_displayStringRowColumn(0,0, "Plz enter old");
-				LCD_displayStringRowColumn(1,0, "pass :");
-				read_send_password();
-				is_password_correct = UART_recieveByte();
+				LCD_displayStringRowColumn_P(0,0,PSTR("Plz enter old"));
+				LCD_displayStringRowColumn_P(1,0,PSTR("pass :"));
+				LCD_flush();
+				login_attempt_size = read_password(login_attempt, &is_typing_too_fast);
+				is_password_correct = control_request(LOGIN_ID, login_attempt, login_attempt_size);
 				num_of_attempts++;
+				/* wrong guesses typed faster than a human count twice against the attempts limit */
+				if((is_password_correct != CORRECT_PASSCODE_ID) && (is_typing_too_fast == TRUE))
+				{
+					num_of_attempts++;
+				}
 				if(num_of_attempts >= MAX_NUM_OF_ATTEMPTS)
 				{
-					UART_sendByte(SYSTEM_NOK_ID);
+					control_request(SYSTEM_NOK_ID, NULL_PTR, 0);
 				}
 				else{
-					UART_sendByte(SYSTEM_OK_ID);
+					control_request(SYSTEM_OK_ID, NULL_PTR, 0);
 				}
-			}while(num_of_attempts < MAX_NUM_OF_ATTEMPTS && is_password_correct != CORRECT_PASSCODE_ID);
+			}while(num_of_attempts < MAX_NUM_OF_ATTEMPTS && is_password_correct != CORRECT_PASSCODE_ID &&
+					is_resync_needed == FALSE);
 		}
 		else if(is_password_correct == CORRECT_PASSCODE_ID)
 		{
 			is_password_correct = FALSE_PASSCODE_ID;
 			num_of_attempts = 0;
-			UART_sendByte(keypad_pressedKey_value);
+			/* events left from a door cycle the HMI ECU resynced out of */
+			while(Link_receive(&door_event) == TRUE){}
+			control_request(keypad_pressedKey_value, NULL_PTR, 0);
 			if(keypad_pressedKey_value == DOOR_OPEN_ID)
 			{
-				LCD_clearScreen();
-				Timer_init(&timer_config);
-				Timer_setCallBack(timer_callBack_motorOP, TIMER1);
-				LCD_displayStringRowColumn(0,1,"Door Unlocking");
-				LCD_displayStringRowColumn(1,4,"Please wait");
-				while(is_door_open == FALSE){}
-				Timer_deInit(TIMER1); /* deactivating until further updates */
-
-				LCD_clearScreen();
-				LCD_displayStringRowColumn(0,0,"wait for people");
-				LCD_displayStringRowColumn(1,3,"To Enter");
-				do
-				{
-					current_state = UART_recieveByte();
-				}while(current_state == PEOPLE_PASS_THROUGH_ID);
-
-				Timer_init(&timer_config);
-				Timer_setCallBack(timer_callBack_motorOP, TIMER1);
-				LCD_clearScreen();
-				LCD_displayStringRowColumn(0,2,"Door Locking");
-				while(is_door_open == TRUE){}
-				Timer_deInit(TIMER1); /* deactivating until further updates */
+				door_session_task();
 			}
 			else if(keypad_pressedKey_value == CHANGE_PASSWORD_ID)
 			{
@@ -135,46 +177,50 @@ int main(void) {
 	return 0;
 }
 
-void timer_callBack_motorOP(void)
+/*
+ * services the link and returns TRUE once the Control ECU has to be synced
+ * again, every wait of the HMI ECU goes through it so the heartbeats keep
+ * flowing and a link loss ends the wait
+ */
+boolean poll_link(void)
 {
-	motor_ticks++;
-	if(motor_ticks == NUM_OF_CTC_PER_15_SEC)
+	Link_poll();
+	if(Link_takeResync() == TRUE)
 	{
-		/*
-		 * if door is opened close it and viceversa
-		 */
-		if(is_door_open == TRUE)
-		{
-			is_door_open = FALSE;
-		}
-		else
-		{
-			is_door_open = TRUE;
-		}
-		motor_ticks = 0;
+		is_resync_needed = TRUE;
 	}
+	return is_resync_needed;
 }
 
-void timer_callBack_systemNOK_OP(void)
+/*
+ * waits for a key press, returns KEYPAD_NO_KEY if the link resynced meanwhile
+ */
+uint8 wait_for_key(void)
 {
-	system_ticks++;
-	if(system_ticks == NUM_OF_CTC_PER_MIN)
+	KEYPAD_EventType keypad_event;
+	while(poll_link() == FALSE)
 	{
-		system_ticks = 0;
-		is_timer_finished = TRUE;
+		if((KEYPAD_getEvent(&keypad_event) == TRUE) && (keypad_event.kind == KEYPAD_EVENT_PRESS))
+		{
+			return keypad_event.key;
+		}
 	}
+	return KEYPAD_NO_KEY;
 }
 
-
-
-void read_send_password(void)
+/*
+ * reads the password from the keypad into the given buffer and returns its
+ * length, the typing check result is returned through the pointer if given
+ */
+uint8 read_password(uint8* password, boolean* is_typing_too_fast_Ptr)
 {
-	uint8 password[7], keypad_pressedKey_value, password_index = 0;
+	uint8 keypad_pressedKey_value, password_index = 0;
+	KEYPAD_TypingStatsType typing_stats;
+	KEYPAD_getTypingStats(&typing_stats); /* clearing stats of the previous keys */
 	for(;;)
 	{
-		keypad_pressedKey_value = KEYPAD_getPressedKey();
-		_delay_ms(400); /* delay for the press duration */
-		if(keypad_pressedKey_value == '=')
+		keypad_pressedKey_value = wait_for_key();
+		if((keypad_pressedKey_value == '=') || (keypad_pressedKey_value == KEYPAD_NO_KEY))
 		{
 			break;
 		}
@@ -183,30 +229,344 @@ void read_send_password(void)
 		{
 			password[password_index++] = keypad_pressedKey_value+ 48;
 			LCD_displayCharacter('*');
+			LCD_flush();
 		}
 	}
-	password[password_index] = UART_RX_STRING_BREAK;
-	password[password_index+1] = '\0';
 
-	UART_sendString(password);
+	KEYPAD_getTypingStats(&typing_stats);
+	if(is_typing_too_fast_Ptr != NULL_PTR)
+	{
+		*is_typing_too_fast_Ptr = (typing_stats.press_count >= 3) &&
+				((typing_stats.total_interval_ms / (typing_stats.press_count - 1)) < MIN_HUMAN_KEY_INTERVAL_MS);
+	}
+	return password_index;
+}
+
+/*
+ * calls the Control ECU and returns the first byte of its reply, the call
+ * is repeated while the Control ECU does not answer. Returns
+ * NO_STATE_RECEIVED if the link resynced, the reply then belongs to a
+ * session that is over
+ */
+uint8 control_request(uint8 request_type, const uint8* payload_Ptr, uint8 length)
+{
+	Link_MessageType reply;
+	Link_StatusType status;
+	Tick_Type message_start;
+	while(poll_link() == FALSE)
+	{
+		status = Link_call(request_type, payload_Ptr, length, &reply);
+		if(poll_link() == TRUE)
+		{
+			break;
+		}
+		if((status == LINK_DONE) && (reply.length > 0) && (reply.payload[0] == PANEL_BUSY_ID))
+		{
+			/* the panel starts over once the other panel is done */
+			panel_busy_task();
+			break;
+		}
+		if(status == LINK_DONE)
+		{
+			return (reply.length > 0) ? reply.payload[0] : NO_STATE_RECEIVED;
+		}
+		LCD_clearScreen();
+		LCD_displayStringRowColumn_P(0,2,PSTR("Control ECU"));
+		LCD_displayStringRowColumn_P(1,1,PSTR("not responding"));
+		LCD_flush();
+		message_start = Tick_getTicks();
+		while((Tick_elapsedSince(message_start) < LINK_ERROR_MESSAGE_TIME_MS) && (poll_link() == FALSE)){}
+	}
+	return NO_STATE_RECEIVED;
+}
+
+/*
+ * waits for the next event pushed by the Control ECU and returns its type,
+ * or NO_STATE_RECEIVED if the link resynced meanwhile. On a bus the events
+ * of the other doors are dropped. A door that stays silent longer than a
+ * move may take asks for a resync, the sync reply tells if it is still busy
+ */
+uint8 wait_for_door_event(void)
+{
+	Tick_Type wait_start = Tick_getTicks();
+	while(poll_link() == FALSE)
+	{
+		if((Link_receive(&door_event) == TRUE) && (door_event.address == selected_door))
+		{
+			return door_event.type;
+		}
+		if(Tick_elapsedSince(wait_start) >= DOOR_EVENT_TIMEOUT_MS)
+		{
+			is_resync_needed = TRUE;
+		}
+	}
+	return NO_STATE_RECEIVED;
 }
+
 void new_password_task(void)
 {
+	/* the password and its confirmation travel in one request separated by the string break */
+	uint8 passwords[(2 * PASSWORD_MAX_SIZE) + 1], passwords_size;
 	do{
 		LCD_clearScreen();
-		LCD_displayString("Plz enter pass:");
+		LCD_displayString_P(PSTR("Plz enter pass:"));
 		LCD_moveCursor(1,0);
+		LCD_flush();
 
-		read_send_password();
+		passwords_size = read_password(passwords, NULL_PTR);
+		passwords[passwords_size++] = UART_RX_STRING_BREAK;
 
 		LCD_clearScreen();
 
-		LCD_displayStringRowColumn(0,0, "Plz re-enter the");
-		LCD_displayStringRowColumn(1,0, "same pass: ");
+		LCD_displayStringRowColumn_P(0,0,PSTR("Plz re-enter the"));
+		LCD_displayStringRowColumn_P(1,0,PSTR("same pass: "));
+		LCD_flush();
 
-		read_send_password();
+		passwords_size += read_password(&passwords[passwords_size], NULL_PTR);
 
 		LCD_clearScreen();
-	}while(UART_recieveByte() != CORRECT_PASSCODE_ID);
+		LCD_flush();
+	}while((control_request(SET_PASSWORD_ID, passwords, passwords_size) != CORRECT_PASSCODE_ID) &&
+			(is_resync_needed == FALSE));
 }
 
+/*
+ * renders the door status pushed by the Control ECU from the open request
+ * until the door is closed again or the move fails, the Control ECU owns
+ * all the door timing
+ */
+void door_session_task(void)
+{
+	uint8 displayed_state = NO_STATE_RECEIVED;
+	for(;;)
+	{
+		switch(wait_for_door_event())
+		{
+		case OPEN_DOOR_STATE_ID:
+		case CLOSE_DOOR_STATE_ID:
+			if(door_event.type != displayed_state)
+			{
+				displayed_state = door_event.type;
+				LCD_clearScreen();
+				if(displayed_state == OPEN_DOOR_STATE_ID)
+				{
+					LCD_displayStringRowColumn_P(0,1,PSTR("Door Unlocking"));
+				}
+				else
+				{
+					LCD_displayStringRowColumn_P(0,2,PSTR("Door Locking"));
+				}
+				LCD_progressBarInit(1, 0, LCD_NUM_COLS);
+			}
+			LCD_progressBarUpdate(door_event.payload[0], 100);
+			LCD_flush();
+			break;
+		case DOOR_REOPEN_ID:
+			door_reopen_task();
+			displayed_state = OPEN_DOOR_STATE_ID; /* the reopening progress is drawn under the message */
+			break;
+		case OPEN_CLOSE_DOOR_DONE:
+			if(door_event.payload[0] == FALSE)
+			{
+				return; /* door closed */
+			}
+			displayed_state = OPEN_CLOSE_DOOR_DONE;
+			LCD_clearScreen();
+			LCD_displayStringRowColumn_P(0,0,PSTR("wait for people"));
+			LCD_displayStringRowColumn_P(1,3,PSTR("To Enter"));
+			LCD_flush();
+			break;
+		case PEOPLE_PASS_THROUGH_ID:
+			displayed_state = PEOPLE_PASS_THROUGH_ID;
+			LCD_clearScreen();
+			LCD_displayStringRowColumn_P(0,1,PSTR("People Passing"));
+			LCD_displayStringRowColumn_P(1,2,PSTR("Please wait"));
+			LCD_flush();
+			break;
+		case DOOR_MOTOR_FAULT_ID:
+			door_fault_task();
+			return;
+		case NO_STATE_RECEIVED:
+			return; /* the link resynced or the door went silent */
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ * tells the user that the door move was stopped by the motor protection
+ */
+void door_fault_task(void)
+{
+	Tick_Type message_start;
+	LCD_clearScreen();
+	LCD_displayStringRowColumn_P(0,2,PSTR("Door Jammed!"));
+	LCD_displayStringRowColumn_P(1,1,PSTR("Motor stopped"));
+	LCD_flush();
+	message_start = Tick_getTicks();
+	while((Tick_elapsedSince(message_start) < DOOR_FAULT_MESSAGE_TIME_MS) && (poll_link() == FALSE)){}
+}
+
+/*
+ * tells the user that the closing door was reversed by an obstruction and how
+ * fast the Control ECU reacted, the reopening progress bar follows on row 1
+ */
+void door_reopen_task(void)
+{
+	uint8 reopen_latency_ms = door_event.payload[0];
+	LCD_clearScreen();
+	LCD_displayStringRowColumn_P(0,0,PSTR("Blocked! "));
+	LCD_displayInteger(reopen_latency_ms, 3, LCD_FORMAT_SPACE_PAD);
+	LCD_displayString_P(PSTR("ms"));
+	LCD_progressBarInit(1, 0, LCD_NUM_COLS);
+	LCD_flush();
+}
+
+/*
+ * keeps the keypad locked for the given time, ends early if the link resyncs
+ * so the Control ECU tells how long is left
+ */
+void lockout_task(uint32 lockout_time_ms)
+{
+	Tick_Type lockout_start = Tick_getTicks();
+	LCD_clearScreen();
+	LCD_displayStringRowColumn_P(0,1,PSTR("System LOCKED"));
+	LCD_displayStringRowColumn_P(1,0,PSTR("wait for "));
+	LCD_displayInteger((sint32)((lockout_time_ms + 999UL) / 1000UL), 2, LCD_FORMAT_SPACE_PAD);
+	LCD_displayString_P(PSTR(" sec"));
+	LCD_flush();
+	while((Tick_elapsedSince(lockout_start) < lockout_time_ms) && (poll_link() == FALSE)){}
+}
+
+/*
+ * syncs with the Control ECU on boot and each time the link comes back, the
+ * sync reply is the state the Control ECU resumed in and the HMI ECU follows it
+ */
+void resync_task(void)
+{
+	Link_MessageType sync_reply;
+	LCD_clearScreen();
+	LCD_displayStringRowColumn_P(0,2,PSTR("Control ECU"));
+	LCD_displayStringRowColumn_P(1,2,PSTR("connecting.."));
+	LCD_flush();
+	while(Link_call(UART_SYNC_CHAR, NULL_PTR, 0, &sync_reply) != LINK_DONE){}
+	/* the link coming up is already answered by this sync */
+	Link_takeResync();
+	is_resync_needed = FALSE;
+	if(sync_reply.length == 0)
+	{
+		return;
+	}
+	switch(sync_reply.payload[0])
+	{
+	case SYNC_NEW_PASSWORD_ID:
+		new_password_task();
+		break;
+	case SYNC_DOOR_BUSY_ID:
+		LCD_clearScreen();
+		LCD_displayStringRowColumn_P(0,3,PSTR("Door in use"));
+		LCD_displayStringRowColumn_P(1,2,PSTR("Please wait"));
+		LCD_flush();
+		door_session_task();
+		break;
+	case SYNC_LOCKOUT_ID:
+		lockout_task((uint32)sync_reply.payload[1] * 1000UL);
+		break;
+	case PANEL_BUSY_ID:
+		panel_busy_task();
+		break;
+	default:
+		break; /* door closed, the login starts over */
+	}
+}
+
+/*
+ * another panel holds the door session, waits for the Control ECU to
+ * broadcast the door free and then syncs again so the user starts over
+ */
+void panel_busy_task(void)
+{
+	Link_MessageType door_status;
+	Tick_Type busy_start = Tick_getTicks();
+	LCD_clearScreen();
+	LCD_displayStringRowColumn_P(0,3,PSTR("Door busy"));
+	LCD_displayStringRowColumn_P(1,1,PSTR("other panel.."));
+	LCD_flush();
+	Link_receiveBroadcast(&door_status); /* sent before the busy reply */
+	while((Tick_elapsedSince(busy_start) < PANEL_BUSY_RETRY_TIME_MS) && (poll_link() == FALSE))
+	{
+		if((Link_receiveBroadcast(&door_status) == TRUE) && (door_status.type == DOOR_STATUS_ID) &&
+				(door_status.payload[DOOR_STATUS_PANEL_INDEX] == DOOR_STATUS_NO_PANEL))
+		{
+			break;
+		}
+	}
+	is_resync_needed = TRUE;
+}
+
+#if DOOR_SELECT_ENABLED
+/*
+ * lists the doors on the bus with the status the link keeps polling, '*'
+ * shows the next door and '=' starts a session with the one shown, the
+ * HMI ECU then syncs with it
+ */
+void door_select_task(void)
+{
+	uint8 door_address = selected_door, keypad_pressedKey_value;
+	Link_NodeStatusType door_status;
+	for(;;)
+	{
+		Link_getNodeStatus(door_address, &door_status);
+		LCD_clearScreen();
+		LCD_displayString_P(PSTR("Door "));
+		LCD_displayInteger(door_address, 2, LCD_FORMAT_SPACE_PAD);
+		LCD_moveCursor(0,8);
+		if(door_status.is_up == FALSE)
+		{
+			LCD_displayString_P(PSTR("offline"));
+		}
+		else
+		{
+			switch(door_status.status[DOOR_STATUS_STATE_INDEX])
+			{
+			case SYNC_NEW_PASSWORD_ID:
+				LCD_displayString_P(PSTR("no pass"));
+				break;
+			case SYNC_DOOR_BUSY_ID:
+				LCD_displayString_P(PSTR("busy"));
+				LCD_displayInteger(door_status.status[DOOR_STATUS_PROGRESS_INDEX], 3, LCD_FORMAT_SPACE_PAD);
+				LCD_displayCharacter('%');
+				break;
+			case SYNC_LOCKOUT_ID:
+				LCD_displayString_P(PSTR("locked!"));
+				break;
+			default:
+				LCD_displayString_P(PSTR("closed"));
+				break;
+			}
+		}
+		LCD_displayStringRowColumn_P(1,0,PSTR("*:next =:select"));
+		LCD_flush();
+
+		keypad_pressedKey_value = wait_for_key();
+		if(keypad_pressedKey_value == KEYPAD_NO_KEY)
+		{
+			return;
+		}
+		if(keypad_pressedKey_value == DOOR_SELECT_KEY)
+		{
+			door_address = (door_address >= (LINK_FIRST_NODE_ADDRESS + LINK_BUS_POLLED_NODES - 1)) ?
+					LINK_FIRST_NODE_ADDRESS : (uint8)(door_address + 1);
+		}
+		else if(keypad_pressedKey_value == '=')
+		{
+			/* the login starts over with the door chosen, even the same one */
+			selected_door = door_address;
+			Link_selectNode(selected_door);
+			is_resync_needed = TRUE;
+			return;
+		}
+	}
+}
+#endif
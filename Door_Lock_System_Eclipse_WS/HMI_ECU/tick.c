@@ -0,0 +1,72 @@
+/*
+ *  File: Source file for System Tick service
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+#include "tick.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static volatile Tick_Type g_tick_count = 0;
+static void(*volatile g_tick_hooks[TICK_MAX_HOOKS])(void);
+static volatile uint8 g_tick_num_of_hooks = 0;
+
+/******************************************************
+ * 				Private Functions
+ ******************************************************/
+/*
+ * Called by the timer driver each compare match
+ */
+static void Tick_callBack(void)
+{
+	uint8 hook_index;
+	g_tick_count++;
+	for(hook_index = 0; hook_index < g_tick_num_of_hooks; hook_index++)
+	{
+		(*g_tick_hooks[hook_index])();
+	}
+}
+
+/******************************************************
+ * 				Function Definitions
+ ******************************************************/
+void Tick_init(void)
+{
+	Timer_ConfigType tick_timer_config = {0, TICK_COMPARE_VALUE, TICK_TIMER_ID, TICK_TIMER_CLOCK, TIMER_COMPARE_MODE};
+	Timer_deInit(TICK_TIMER_ID);
+	Timer_setCallBack(Tick_callBack, TICK_TIMER_ID);
+	Timer_init(&tick_timer_config);
+}
+
+Tick_Type Tick_getTicks(void)
+{
+	Tick_Type ticks;
+	uint8 sreg_value = SREG;
+	/* 32-bit value is updated by the ISR so it must be read atomically */
+	cli();
+	ticks = g_tick_count;
+	SREG = sreg_value;
+	return ticks;
+}
+
+Tick_Type Tick_elapsedSince(Tick_Type start_tick)
+{
+	return (Tick_getTicks() - start_tick);
+}
+
+boolean Tick_addHook(void(*a_hook_ptr)(void))
+{
+	uint8 sreg_value;
+	if(g_tick_num_of_hooks >= TICK_MAX_HOOKS)
+	{
+		return FALSE;
+	}
+	sreg_value = SREG;
+	cli();
+	g_tick_hooks[g_tick_num_of_hooks] = a_hook_ptr;
+	g_tick_num_of_hooks++;
+	SREG = sreg_value;
+	return TRUE;
+}
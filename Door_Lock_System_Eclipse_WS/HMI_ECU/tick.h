@@ -0,0 +1,68 @@
+/*
+ *  File: Header file for System Tick service
+ *
+ *  Created on: 19/10/2026
+ *
+ *  Author: Seifalla Ehab
+ */
+
+#ifndef TICK_H_
+#define TICK_H_
+
+#include "std_types.h"
+#include "timer.h"
+
+/*********************************************************
+ * 						Types
+ *********************************************************/
+/* milliseconds since Tick_init(), wraps after ~49 days */
+typedef uint32 Tick_Type;
+
+/*********************************************************
+ * 					Definitions
+ *********************************************************/
+/*
+ * Timer0 is not used by the HMI ECU so it is dedicated to the tick,
+ * compare mode with prescaler 64 gives a 1 ms period
+ */
+#define TICK_TIMER_ID					TIMER0
+#define TICK_TIMER_CLOCK				F_CLK_PRESCALE_64
+#define TICK_TIMER_PRESCALE				64UL
+#define TICK_PERIOD_MS					1u
+#define TICK_COMPARE_VALUE				((uint16)((F_CPU / TICK_TIMER_PRESCALE / 1000UL) - 1))
+
+/*
+ * Number of functions that can be attached to the tick interrupt,
+ * hooks run in interrupt context so they must be short and non-blocking
+ */
+#define TICK_MAX_HOOKS					4u
+
+/*********************************************************
+ * 					Function Prototype
+ *********************************************************/
+/*
+ * Description:
+ * Starts the tick timer, must be called before any tick based module is used
+ */
+void Tick_init(void);
+
+/*
+ * Description:
+ * Returns the number of milliseconds passed since Tick_init()
+ */
+Tick_Type Tick_getTicks(void);
+
+/*
+ * Description:
+ * Returns the number of milliseconds passed since the given tick value (wrap safe)
+ */
+Tick_Type Tick_elapsedSince(Tick_Type start_tick);
+
+/*
+ * Description:
+ * Attaches a function to be called every tick from the timer ISR
+ * returns FALSE if the hook table is full
+ */
+boolean Tick_addHook(void(*a_hook_ptr)(void));
+
+#endif /* TICK_H_ */